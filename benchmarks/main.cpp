@@ -0,0 +1,539 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+#  include "MyLogger/Grep.hpp"
+
+using namespace mylogger;
+
+//! \brief File of the benchmarked logger.
+static const char* c_log_file = "/tmp/MyLogger/benchmark.log";
+
+//------------------------------------------------------------------------------
+//! \brief Return the given percentile of sorted samples.
+//------------------------------------------------------------------------------
+static double percentile(std::vector<double> const& sorted, double const p)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t const index = size_t(p * double(sorted.size() - 1u));
+    return sorted[index];
+}
+
+//------------------------------------------------------------------------------
+//! \brief Latency of LOGI measured call by call. The percentiles (in
+//! nanoseconds) are reported as counters.
+//------------------------------------------------------------------------------
+static void LOGI_Latency(benchmark::State& state)
+{
+    std::vector<double> samples;
+    samples.reserve(1000000u);
+
+    Logger::instance().changeLog(c_log_file);
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        LOGI("Hello World from benchmark line %u", i++);
+        auto const stop = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    Logger::destroy();
+
+    std::sort(samples.begin(), samples.end());
+    state.counters["p50_ns"] = percentile(samples, 0.50);
+    state.counters["p99_ns"] = percentile(samples, 0.99);
+    state.counters["p99.9_ns"] = percentile(samples, 0.999);
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_Latency)->Iterations(200000);
+
+//------------------------------------------------------------------------------
+//! \brief Lines per second of LOGI for a growing number of threads, in
+//! synchronous (argument 0) and asynchronous (argument 1) mode.
+//------------------------------------------------------------------------------
+static void LOGI_Throughput(benchmark::State& state)
+{
+    // All threads wait for the first one before their first iteration.
+    if (state.thread_index() == 0)
+    {
+        Logger::instance().changeLog(c_log_file);
+        if (state.range(0) != 0)
+        {
+            Logger::instance().startAsync(8192u, QueueFullPolicy::Block);
+        }
+    }
+
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI("Hello World from thread %3d line %u", state.thread_index(), i++);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+
+    if (state.thread_index() == 0)
+    {
+        Logger::destroy(); // Queued lines are written
+    }
+}
+BENCHMARK(LOGI_Throughput)->ArgName("async")->Arg(0)->Arg(1)
+    ->ThreadRange(1, int(std::max(2u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
+
+//------------------------------------------------------------------------------
+//! \brief Same content logged by CPP_LOG (argument 1) or LOGI (argument 0).
+//------------------------------------------------------------------------------
+static void CPP_LOG_Versus_LOGI(benchmark::State& state)
+{
+    bool const cpp_log = (state.range(0) != 0);
+
+    Logger::instance().changeLog(c_log_file);
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        if (cpp_log)
+        {
+            CPP_LOG(Info) << "Line " << i++ << " value " << 3.5 << " " << "text";
+        }
+        else
+        {
+            LOGI("Line %u value %g %s", i++, 3.5, "text");
+        }
+    }
+    Logger::destroy();
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(CPP_LOG_Versus_LOGI)->ArgName("cpp_log")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+//! \brief Return the size of a file (0 if it does not exist).
+//------------------------------------------------------------------------------
+static double fileSize(const char* path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? double(file.tellg()) : 0.0;
+}
+
+//------------------------------------------------------------------------------
+//! \brief LOGI writing each line immediately (argument 0) or batched by
+//! 64 KiB (argument 1). The number of write() system calls per line is
+//! reported as a counter.
+//------------------------------------------------------------------------------
+static void LOGI_FlushPolicy(benchmark::State& state)
+{
+    FlushPolicy policy;
+    if (state.range(0) == 0)
+    {
+        policy.bytes = 0u;
+    }
+
+    Logger::instance().changeLog(c_log_file);
+    Logger::instance().flushPolicy(policy);
+    Stats before;
+    Metrics::collect(before);
+
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI("Hello World from benchmark line %u", i++);
+    }
+    Logger::destroy();
+
+    Stats after;
+    Metrics::collect(after);
+    state.counters["syscalls_per_line"] =
+        double(after.flushes - before.flushes) / double(state.iterations());
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_FlushPolicy)->ArgName("batched")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+//! \brief LOGI into a text (argument 0) or a binary (argument 1) file. The
+//! size of the file per line is reported as a counter.
+//------------------------------------------------------------------------------
+static void LOGI_FileFormat(benchmark::State& state)
+{
+    Logger::instance().fileFormat((state.range(0) != 0) ? FileFormat::Binary : FileFormat::Text);
+    Logger::instance().changeLog(c_log_file);
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI("Hello World from benchmark line %u", i++);
+    }
+    Logger::destroy();
+
+    state.counters["bytes_per_line"] = fileSize(c_log_file) / double(state.iterations());
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_FileFormat)->ArgName("binary")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+//! \brief LOGI of long messages (first argument: their size), in synchronous
+//! (second argument 0) and asynchronous (second argument 1) mode.
+//------------------------------------------------------------------------------
+static void LOGI_LongLines(benchmark::State& state)
+{
+    std::string const text(size_t(state.range(0)), 'x');
+
+    Logger::instance().changeLog(c_log_file);
+    if (state.range(1) != 0)
+    {
+        Logger::instance().startAsync(64u, QueueFullPolicy::Block);
+    }
+
+    for (auto _: state)
+    {
+        LOGI("%s", text.c_str());
+    }
+    Logger::destroy(); // Queued lines are written
+    state.SetItemsProcessed(int64_t(state.iterations()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0));
+}
+BENCHMARK(LOGI_LongLines)->ArgNames({"size", "async"})
+    ->Args({1024, 0})->Args({1024, 1})
+    ->Args({64 * 1024, 0})->Args({64 * 1024, 1})
+    ->Args({1024 * 1024, 0})->Args({1024 * 1024, 1});
+
+//------------------------------------------------------------------------------
+//! \brief Cost of a LOGI statement below the runtime threshold. Its argument
+//! shall not be evaluated.
+//------------------------------------------------------------------------------
+static void LOGI_Disabled(benchmark::State& state)
+{
+    Logger::instance().changeLog(c_log_file);
+    ILogger::threshold(Error);
+    uint32_t evaluated = 0u;
+    for (auto _: state)
+    {
+        LOGI("Not logged %u", ++evaluated);
+    }
+    ILogger::threshold(None);
+    Logger::destroy();
+
+    benchmark::DoNotOptimize(evaluated);
+    if (evaluated != 0u)
+    {
+        state.SkipWithError("Arguments of disabled statements are evaluated");
+    }
+}
+BENCHMARK(LOGI_Disabled);
+
+//------------------------------------------------------------------------------
+//! \brief LOGI given a callable argument, below the runtime threshold
+//! (argument 0) or logged (argument 1). The callable shall only be called
+//! when the line is logged.
+//------------------------------------------------------------------------------
+static void LOGI_LazyArgument(benchmark::State& state)
+{
+    bool const logged = (state.range(0) != 0);
+
+    Logger::instance().changeLog(c_log_file);
+    ILogger::threshold(logged ? None : Error);
+    uint32_t evaluated = 0u;
+    auto dump = [&evaluated]() { return std::to_string(++evaluated); };
+    for (auto _: state)
+    {
+        LOGI("State: %s", dump);
+    }
+    ILogger::threshold(None);
+    Logger::destroy();
+
+    benchmark::DoNotOptimize(evaluated);
+    if (evaluated != (logged ? uint32_t(state.iterations()) : 0u))
+    {
+        state.SkipWithError("Callables are not called only when logged");
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_LazyArgument)->ArgName("logged")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+//! \brief Cost of changeLog(): closing the file (footer) and opening another
+//! one (header).
+//------------------------------------------------------------------------------
+static void ChangeLog(benchmark::State& state)
+{
+    const char* files[] = { "/tmp/MyLogger/benchmark1.log", "/tmp/MyLogger/benchmark2.log" };
+    size_t i = 0u;
+
+    // changeLog() prints the path of the new file on the console.
+    std::streambuf* console = std::cout.rdbuf(nullptr);
+    for (auto _: state)
+    {
+        Logger::instance().changeLog(files[i++ & 1u]);
+    }
+    Logger::destroy();
+    std::cout.rdbuf(console);
+}
+BENCHMARK(ChangeLog);
+
+//------------------------------------------------------------------------------
+//! \brief LOGI with the log file only (argument 0), plus a FileSink
+//! (argument 1), plus a ConsoleSink writing into /dev/null (argument 2).
+//------------------------------------------------------------------------------
+static void Sinks_FileVersusConsole(benchmark::State& state)
+{
+    int const null = ::open("/dev/null", O_WRONLY);
+
+    Logger::instance().changeLog(c_log_file);
+    if (state.range(0) == 1)
+    {
+        Logger::instance().addSink(std::make_shared<FileSink>("/tmp/MyLogger/sink.log"));
+    }
+    else if (state.range(0) == 2)
+    {
+        Logger::instance().addSink(std::make_shared<ConsoleSink>(null));
+    }
+
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI("Hello World from benchmark line %u", i++);
+    }
+    Logger::destroy();
+    ::close(null);
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(Sinks_FileVersusConsole)->ArgName("sink")->Arg(0)->Arg(1)->Arg(2);
+
+//------------------------------------------------------------------------------
+//! \brief LOGIS (written directly on the file descriptor of the standard
+//! output) in synchronous (argument 0) and asynchronous (argument 1) mode,
+//! versus the same line given to a std::ostream (argument 2). The standard
+//! output is redirected into /dev/null.
+//------------------------------------------------------------------------------
+static void LOGIS_Console(benchmark::State& state)
+{
+    std::ofstream null("/dev/null");
+    fflush(stdout);
+    int const saved = ::dup(1);
+    int const fd = ::open("/dev/null", O_WRONLY);
+    ::dup2(fd, 1);
+
+    Logger::instance().changeLog(c_log_file);
+    if (state.range(0) == 1)
+    {
+        Logger::instance().startAsync(8192u, QueueFullPolicy::Block);
+    }
+
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        if (state.range(0) == 2)
+        {
+            MYLOGGER_LOG_SITE(&null, Info, SHORT_FILENAME, "Hello World from benchmark line %u", i++);
+        }
+        else
+        {
+            LOGIS("Hello World from benchmark line %u", i++);
+        }
+    }
+    Logger::destroy();
+
+    fflush(stdout);
+    ::dup2(saved, 1);
+    ::close(saved);
+    ::close(fd);
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGIS_Console)->ArgName("mode")->Arg(0)->Arg(1)->Arg(2);
+
+//------------------------------------------------------------------------------
+//! \brief LOGI_KV written as text (argument 0), JSON Lines (argument 1) or
+//! logfmt (argument 2).
+//------------------------------------------------------------------------------
+static void LOGI_KV_Formats(benchmark::State& state)
+{
+    Fields::format(FieldFormat(state.range(0)));
+    Logger::instance().changeLog(c_log_file);
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI_KV("request done", "user", "Joe \"the\" user", "id", i++, "latency_us", 12.5);
+    }
+    Logger::destroy();
+    Fields::format(FieldFormat::Text);
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_KV_Formats)->ArgName("format")->Arg(0)->Arg(1)->Arg(2);
+
+//------------------------------------------------------------------------------
+//! \brief LOGI with the default layout (argument 0), the layout "%T.%u %L
+//! [%f:%l] " parsed at runtime (argument 1) or composed at compile time
+//! (argument 2).
+//------------------------------------------------------------------------------
+static void LOGI_Layout(benchmark::State& state)
+{
+    Logger::instance().changeLog(c_log_file);
+    if (state.range(0) == 1)
+    {
+        Logger::instance().layout(Layout("%T.%u %L [%f:%l] "));
+    }
+    else if (state.range(0) == 2)
+    {
+        using namespace mylogger::layout;
+        Logger::instance().layout(Layout::of<Hms, Text<'.'>, Micros, Text<' '>, Level,
+                                             Text<' ', '['>, Filename, Text<':'>, Line,
+                                             Text<']', ' '>>());
+    }
+
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI("Hello World from benchmark line %u", i++);
+    }
+    Logger::instance().layout(Layout());
+    Logger::destroy();
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_Layout)->ArgName("layout")->Arg(0)->Arg(1)->Arg(2);
+
+//------------------------------------------------------------------------------
+//! \brief Cost of LOGI without (argument 0) and with (argument 1) the latency
+//! histogram of the metrics.
+//------------------------------------------------------------------------------
+static void LOGI_Metrics(benchmark::State& state)
+{
+    Metrics::latency(state.range(0) != 0);
+    Logger::instance().changeLog(c_log_file);
+    uint32_t i = 0u;
+    for (auto _: state)
+    {
+        LOGI("Hello World from benchmark line %u", i++);
+    }
+    Logger::destroy();
+    Metrics::latency(false);
+
+    Stats stats;
+    Metrics::collect(stats);
+    state.counters["p99_ns"] = double(stats.percentile(0.99));
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(LOGI_Metrics)->ArgName("latency")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+//! \brief Count the ERROR lines of a log file read by std::getline (argument
+//! 0), searched by Grep on their severity (argument 1) or on their text
+//! (argument 2, jumping from one occurrence to the next).
+//------------------------------------------------------------------------------
+static void Grep_Errors(benchmark::State& state)
+{
+    const char* path = "/tmp/MyLogger/grep.log";
+    Logger::instance().changeLog(path);
+    for (uint32_t i = 0u; i < 200000u; ++i)
+    {
+        if (i % 1000u == 0u)
+        {
+            LOGE("Error from benchmark line %u", i);
+        }
+        else
+        {
+            LOGI("Hello World from benchmark line %u", i);
+        }
+    }
+    Logger::destroy();
+
+    std::ifstream file(path);
+    std::string const log((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+    Grep::Query query;
+    if (state.range(0) == 1)
+    {
+        query.severity = Error;
+    }
+    else
+    {
+        query.text = "Error from";
+    }
+
+    size_t errors = 0u;
+    for (auto _: state)
+    {
+        errors = 0u;
+        if (state.range(0) == 0)
+        {
+            std::istringstream stream(log);
+            std::string line;
+            while (std::getline(stream, line))
+            {
+                errors += (line.find("][ERROR][") != std::string::npos);
+            }
+        }
+        else
+        {
+            Grep grep(log.data(), log.size(), query);
+            Grep::Line line;
+            while (grep.next(line))
+            {
+                ++errors;
+            }
+        }
+    }
+
+    if (errors != 200u)
+    {
+        state.SkipWithError("Wrong number of ERROR lines");
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(log.size()));
+}
+BENCHMARK(Grep_Errors)->ArgName("search")->Arg(0)->Arg(1)->Arg(2);
+
+//------------------------------------------------------------------------------
+//! \brief Cost of instance() once the singleton exists, for each policy.
+//------------------------------------------------------------------------------
+template <template <class> class Policy>
+class Dummy: public Policy<Dummy<Policy>>
+{
+    friend class Policy<Dummy<Policy>>;
+
+public:
+
+    int value = 0;
+
+private:
+
+    Dummy() = default;
+};
+
+template <class T>
+static void Singleton_Instance(benchmark::State& state)
+{
+    for (auto _: state)
+    {
+        benchmark::DoNotOptimize(&T::instance());
+    }
+}
+BENCHMARK_TEMPLATE(Singleton_Instance, Dummy<LongLifeSingleton>);
+BENCHMARK_TEMPLATE(Singleton_Instance, Dummy<ThreadCachedSingleton>);
+BENCHMARK_TEMPLATE(Singleton_Instance, Dummy<LazySingleton>);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_ARCHIVER_HPP
+#  define MYLOGGER_ARCHIVER_HPP
+
+#  include <chrono>
+#  include <condition_variable>
+#  include <ctime>
+#  include <deque>
+#  include <mutex>
+#  include <string>
+#  include <thread>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief When the log file is rotated and how many old files are kept.
+// *****************************************************************************
+struct RotationPolicy
+{
+    //! \brief Rotate when the file reaches this size (0: never).
+    uint64_t bytes = 0u;
+    //! \brief Rotate at each multiple of this duration since the Epoch, for
+    //! example each UTC midnight for 24 hours (0: never).
+    std::chrono::seconds interval{0};
+    //! \brief Number of old files kept: name.1.log (the most recent) up to
+    //! name.<generations>.log.
+    size_t generations = 5u;
+    //! \brief Compress old files with gzip (name.1.log.gz).
+    bool compress = true;
+};
+
+// *****************************************************************************
+//! \brief Decide when the log file is rotated and archive the rotated files
+//! on a background thread: give the log path to the new file, shift the
+//! generations, remove the oldest one and compress the newest one. The logging
+//! thread only has to close the file and open a new one under a fresh name:
+//! no rename is done while it holds its lock.
+// *****************************************************************************
+class Archiver
+{
+public:
+
+    Archiver() = default;
+
+    //! \brief Archive the pending files then stop the background thread.
+    ~Archiver();
+
+    //! \brief Change the rotation policy. The next time boundary is computed
+    //! from now.
+    void policy(RotationPolicy const& policy);
+
+    //! \brief Is rotation enabled ?
+    bool enabled() const
+    {
+        return (m_policy.bytes != 0u) || (m_policy.interval.count() != 0);
+    }
+
+    //! \brief Shall a file of the given size be rotated now ?
+    bool due(uint64_t const size);
+
+    //! \brief Return a unique name where the next file can be opened while
+    //! the closed one is still at the log path.
+    std::string incoming(std::string const& path);
+
+    //! \brief Archive, on the background thread, the closed file at the given
+    //! log path as its newest generation, then move the incoming file, already
+    //! in use, to the log path.
+    void archive(std::string const& path, std::string const& incoming);
+
+    //! \brief Wait until all files given to archive() are archived, for
+    //! example before opening the log path again.
+    void wait();
+
+    //! \brief Return the name of an old log file: "dir/name.<index>.ext".
+    static std::string generation(std::string const& path, size_t const index);
+
+private:
+
+    //! \brief Body of the background thread.
+    void run();
+
+    //! \brief Move the incoming file to the log path, shift the generations
+    //! and move the closed file as the first generation.
+    static void process(std::string const& path, std::string const& incoming,
+                        RotationPolicy const& policy);
+
+    //! \brief Compress a file with gzip.
+    static bool compress(std::string const& source, std::string const& destination);
+
+private:
+
+    //! \brief A rotated file waiting to be archived.
+    struct Job
+    {
+        std::string path;
+        std::string incoming;
+        RotationPolicy policy;
+    };
+
+    RotationPolicy m_policy;
+    //! \brief Next time boundary (0: none).
+    time_t m_next = 0;
+    uint64_t m_sequence = 0u;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_done;
+    std::deque<Job> m_jobs;
+    bool m_busy = false;
+    bool m_stop = false;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_ARCHIVER_HPP */
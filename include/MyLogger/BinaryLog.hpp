@@ -0,0 +1,161 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_BINARYLOG_HPP
+#  define MYLOGGER_BINARYLOG_HPP
+
+#  include "MyLogger/BufferedFile.hpp"
+#  include <limits>
+#  include <string>
+#  include <vector>
+
+//! \brief Binary log files. They start with the magic number c_magic followed
+//! by records, each one starting with its Tag:
+//!   - Definition: varint id, severity byte, varint line, varint length +
+//!     file name, varint length + printf format. The table of the log
+//!     statements known when the file is opened is written first, next to the
+//!     header; statements met later are defined before their first use.
+//!   - Statement: varint id, zigzag varint time delta in nanoseconds with the
+//!     previous record, varint length + arguments (encoded by deferred::encode()
+//!     without their Header).
+//!   - Text: severity byte, zigzag varint time delta, varint length + already
+//!     formatted text (banners, C++ style lines).
+namespace mylogger {
+namespace binary {
+
+//! \brief First bytes of a binary log file.
+static const char c_magic[8] = { 'M', 'Y', 'L', 'O', 'G', 'B', 'I', 'N' };
+
+// *****************************************************************************
+//! \brief Kind of the records of binary log files.
+// *****************************************************************************
+enum Tag : uint8_t
+{
+    Definition = 'S', Statement = 'R', Text = 'T'
+};
+
+// *****************************************************************************
+//! \brief Encode log statements and texts as records of a binary log file.
+//!
+//! \note This class is not thread safe: the logger serializes the calls.
+// *****************************************************************************
+class Writer
+{
+public:
+
+    //! \brief Begin a new file: write the magic number and the table of the
+    //! log statements registered so far.
+    void start(BufferedFile& file);
+
+    //! \brief Append an encoded log statement (see deferred::encode()).
+    void statement(BufferedFile& file, const char* record, size_t const length);
+
+    //! \brief Append a formatted text.
+    void text(BufferedFile& file, const char* text, size_t const length,
+              enum Severity const severity);
+
+private:
+
+    //! \brief Write the definition of the log statements up to the given
+    //! identifier (excluded) not yet written.
+    void define(BufferedFile& file, uint32_t const until);
+
+    //! \brief Return the zigzag encoding of the time elapsed since the
+    //! previous record.
+    uint64_t delta(uint64_t const time);
+
+private:
+
+    //! \brief Number of log statements defined in the file.
+    uint32_t m_defined = 0u;
+    //! \brief Time of the previous record (nanoseconds since the Epoch).
+    uint64_t m_time = 0u;
+};
+
+// *****************************************************************************
+//! \brief Which records a Reader keeps.
+// *****************************************************************************
+struct Filter
+{
+    //! \brief Lowest severity kept, in the order of rank() (None:
+    //! everything).
+    enum Severity severity = None;
+    //! \brief Time range kept, in nanoseconds since the Epoch.
+    uint64_t from = 0u;
+    uint64_t to = std::numeric_limits<uint64_t>::max();
+    //! \brief Base name of the source file kept (empty: all). Texts have no
+    //! file and are skipped when set.
+    std::string file;
+};
+
+// *****************************************************************************
+//! \brief Decode a binary log file back to the text format of Logger.
+// *****************************************************************************
+class Reader
+{
+public:
+
+    //! \brief Decode the given content of a binary log file.
+    Reader(const char* data, size_t const size, Filter const& filter = Filter());
+
+    //! \brief Does the content start with the magic number ?
+    bool valid() const
+    {
+        return m_valid;
+    }
+
+    //! \brief Decode the next line kept by the filter.
+    //! \return false at the end of the file or on corrupted data.
+    bool next(std::string& line);
+
+private:
+
+    //! \brief A log statement defined in the file.
+    struct Site
+    {
+        enum Severity severity;
+        std::string file;
+        std::string format;
+        std::string location;
+    };
+
+    bool byte(uint8_t& value);
+    bool varint(uint64_t& value);
+    bool bytes(const char*& data, size_t& length);
+    bool define();
+    bool time(uint64_t& time);
+    bool kept(enum Severity const severity, uint64_t const time) const;
+
+private:
+
+    const char* m_cursor;
+    const char* m_end;
+    bool m_valid;
+    Filter m_filter;
+    std::vector<Site> m_sites;
+    uint64_t m_time = 0u;
+    //! \brief Encoded log statement rebuilt for deferred::format().
+    std::string m_record;
+};
+
+} // namespace binary
+} // namespace mylogger
+
+#endif /* MYLOGGER_BINARYLOG_HPP */
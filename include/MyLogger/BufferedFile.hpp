@@ -0,0 +1,116 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_BUFFEREDFILE_HPP
+#  define MYLOGGER_BUFFEREDFILE_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include <chrono>
+#  include <string>
+#  include <vector>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief When a BufferedFile writes its buffer into the file.
+// *****************************************************************************
+struct FlushPolicy
+{
+    //! \brief Flush when this number of bytes is buffered (0: flush each line).
+    size_t bytes = 64u * 1024u;
+    //! \brief Flush when the oldest buffered line is older than this duration.
+    std::chrono::milliseconds interval{1000};
+    //! \brief Flush immediately after a line of this severity or higher.
+    enum Severity severity = Error;
+};
+
+// *****************************************************************************
+//! \brief Log file accumulating lines in memory and writing them with a single
+//! write() system call per batch instead of one per line.
+//!
+//! \note This class is not thread safe: the logger serializes the calls.
+// *****************************************************************************
+class BufferedFile
+{
+public:
+
+    BufferedFile();
+    ~BufferedFile();
+
+    //! \brief Create or truncate the file. Close the previous one.
+    //! \param append if true, the content of the file is kept.
+    //! \return false if the file cannot be opened (errno is set).
+    bool open(std::string const& path, bool const append = false);
+
+    //! \brief Flush the buffer and close the file.
+    void close();
+
+    //! \brief Is the file opened ?
+    bool isOpen() const
+    {
+        return m_fd >= 0;
+    }
+
+    //! \brief Change when the buffer is written into the file.
+    void policy(FlushPolicy const& policy);
+
+    //! \brief Append data to the buffer then flush it if the policy says so.
+    void write(const char* data, size_t const length, enum Severity const severity);
+
+    //! \brief Write the whole buffer into the file.
+    void flush();
+
+    //! \brief Flush the buffer if its oldest line is older than the policy
+    //! interval. Called by the writer thread when idle.
+    void flushIfExpired();
+
+    //! \brief Return the number of bytes written since the file was opened
+    //! (including the buffered ones).
+    uint64_t size() const
+    {
+        return m_size;
+    }
+
+    //! \brief Return the number of write() system calls done so far.
+    uint64_t syscalls() const
+    {
+        return m_syscalls;
+    }
+
+private:
+
+    //! \brief Write directly into the file.
+    void writeAll(const char* data, size_t length);
+
+private:
+
+    int m_fd = -1;
+    FlushPolicy m_policy;
+    std::vector<char> m_buffer;
+    size_t m_length = 0u;
+    uint64_t m_size = 0u;
+    //! \brief Time of the oldest line in the buffer.
+    std::chrono::steady_clock::time_point m_oldest;
+    uint64_t m_syscalls = 0u;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_BUFFEREDFILE_HPP */
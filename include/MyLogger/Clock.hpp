@@ -0,0 +1,127 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_CLOCK_HPP
+#  define MYLOGGER_CLOCK_HPP
+
+#  include <cstddef>
+#  include <cstdint>
+#  include <ctime>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Where the time of log lines comes from.
+// *****************************************************************************
+enum class ClockSource
+{
+    //! \brief CLOCK_REALTIME_COARSE: cheapest, resolution of a few
+    //! milliseconds (CLOCK_REALTIME when not available).
+    Coarse,
+    //! \brief CLOCK_REALTIME.
+    Precise,
+    //! \brief Raw TSC ticks of the CPU, converted to a date when the line is
+    //! formatted (CLOCK_REALTIME when not an x86 CPU).
+    Tsc
+};
+
+// *****************************************************************************
+//! \brief Number of digits after the seconds in log lines.
+// *****************************************************************************
+enum class TimePrecision
+{
+    Seconds, Milliseconds, Microseconds, Nanoseconds
+};
+
+// *****************************************************************************
+//! \brief Time of a log line as captured by the calling thread.
+// *****************************************************************************
+struct Timestamp
+{
+    //! \brief Nanoseconds since the Epoch, or raw TSC ticks when tsc is set.
+    uint64_t value;
+    bool tsc;
+};
+
+// *****************************************************************************
+//! \brief Local date and time of a second, broken down and formatted.
+// *****************************************************************************
+struct LocalTime
+{
+    time_t second = -1;
+    struct tm tm;
+    //! \brief "HH:MM:SS" (not terminated).
+    char hms[8];
+    //! \brief "YYYY/MM/DD" (not terminated).
+    char date[10];
+};
+
+// *****************************************************************************
+//! \brief Timestamp engine of log lines. Reading the time is a single
+//! clock_gettime() (or rdtsc) call. Formatting caches, for each thread, the
+//! local time of the current second so localtime() is called once per
+//! second, and only rewrites the fractional part.
+//!
+//! \note Configure it before threads start logging.
+// *****************************************************************************
+class Clock
+{
+public:
+
+    //! \brief Change the source of the time (by default: Precise). Choosing
+    //! Tsc calibrates the TSC frequency against CLOCK_REALTIME (about 10 ms).
+    static void source(ClockSource const source);
+
+    //! \brief Return the source of the time.
+    static ClockSource source();
+
+    //! \brief Change the precision of formatted times (by default:
+    //! Seconds, sub-second digits are opt-in).
+    static void precision(TimePrecision const precision);
+
+    //! \brief Return the current time.
+    static Timestamp now();
+
+    //! \brief Convert a timestamp to nanoseconds since the Epoch.
+    static uint64_t nanoseconds(Timestamp const& when);
+
+    //! \brief Convert a timestamp to seconds since the Epoch.
+    static time_t seconds(Timestamp const& when)
+    {
+        return time_t(nanoseconds(when) / 1000000000u);
+    }
+
+    //! \brief Format the local time as "[%H:%M:%S.uuuuuu]" depending on the
+    //! precision.
+    //! \return the number of chars written (without the final '\0').
+    static size_t format(char* buffer, size_t const size, Timestamp const& when);
+
+    //! \brief Return the local time of the given second. Each thread caches
+    //! the last one: localtime() is only called when the second changes.
+    static LocalTime const& local(time_t const second);
+
+    //! \brief Write an unsigned integer with a fixed number of digits
+    //! (leading zeros, higher digits are lost).
+    static void digits(char* buffer, uint32_t value, size_t const count);
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_CLOCK_HPP */
@@ -0,0 +1,112 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_CONSOLE_HPP
+#  define MYLOGGER_CONSOLE_HPP
+
+#  include "MyLogger/Severity.hpp"
+#  include <cstddef>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief When the console colors the lines depending on their severity.
+// *****************************************************************************
+enum class ColorMode
+{
+    //! \brief Only when the file descriptor is a terminal (and neither
+    //! NO_COLOR is set nor TERM is "dumb").
+    Auto,
+    Always,
+    Never
+};
+
+// *****************************************************************************
+//! \brief Write lines directly on a file descriptor (the standard output or
+//! error), without std::ostream nor stdio. A line is written by a single
+//! writev() system call gathering the escape sequence of its color (computed
+//! at compile time), the line and the reset sequence, without copying them.
+//! Lines can also be batched and written together by flush().
+//!
+//! write() and writeLine() are async-signal-safe.
+// *****************************************************************************
+class Console
+{
+public:
+
+    //! \brief Size of the batch of append().
+    constexpr static size_t c_batch_size = 16u * 1024u;
+
+    //! \brief The color mode is resolved here, once.
+    explicit Console(int const fd = 1, ColorMode const mode = ColorMode::Auto);
+
+    //! \brief Write the batched lines.
+    ~Console();
+
+    //! \brief Return the file descriptor.
+    int fd() const
+    {
+        return m_fd;
+    }
+
+    //! \brief Are lines colored ?
+    bool colored() const
+    {
+        return m_colored;
+    }
+
+    //! \brief Change when lines are colored.
+    void colors(ColorMode const mode)
+    {
+        m_colored = colored(m_fd, mode);
+    }
+
+    //! \brief Write a line now, colored depending on its severity.
+    void write(enum Severity const severity, const char* line, size_t const length)
+    {
+        writeLine(m_fd, m_colored, severity, line, length);
+    }
+
+    //! \brief Copy a line into the batch. The batch is written when full or
+    //! by flush().
+    void append(enum Severity const severity, const char* line, size_t const length);
+
+    //! \brief Write the batched lines.
+    void flush();
+
+    //! \brief Write a line on the given file descriptor, colored or not.
+    static void writeLine(int const fd, bool const colored, enum Severity const severity,
+                          const char* line, size_t const length);
+
+    //! \brief Should the given file descriptor be colored in the given mode ?
+    static bool colored(int const fd, ColorMode const mode);
+
+private:
+
+    int m_fd;
+    bool m_colored;
+    size_t m_length = 0u;
+    char m_batch[c_batch_size];
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_CONSOLE_HPP */
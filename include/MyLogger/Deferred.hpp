@@ -0,0 +1,214 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_DEFERRED_HPP
+#  define MYLOGGER_DEFERRED_HPP
+
+#  include "MyLogger/Clock.hpp"
+#  include <cstdarg>
+#  include <cstdint>
+#  include <cstring>
+#  include <type_traits>
+
+namespace mylogger {
+namespace deferred {
+
+// *****************************************************************************
+//! \brief Type of an argument stored inside an encoded log statement.
+// *****************************************************************************
+enum Type : uint8_t
+{
+    Int, UInt, Double, String, Pointer
+};
+
+// *****************************************************************************
+//! \brief Beginning of an encoded log statement. It is followed by the
+//! arguments: for each of them, its Type then its raw value (strings are
+//! copied with their final '\0'). The format, the severity and the location
+//! are given by the identifier of the log statement (see Sites).
+// *****************************************************************************
+struct Header
+{
+    uint32_t site;
+    Timestamp time;
+};
+
+// *****************************************************************************
+//! \brief Serialize printf arguments as raw binary values. Values which do not
+//! fit in the buffer are not stored: the formatter will print them as '?'.
+// *****************************************************************************
+class Encoder
+{
+public:
+
+    Encoder(char* buffer, size_t const size)
+        : m_buffer(buffer), m_size(size), m_length(0u)
+    {}
+
+    //! \brief Store the header of the log statement.
+    void header(Header const& header)
+    {
+        raw(&header, sizeof (header));
+    }
+
+    //! \brief Store a signed integer (or an enum).
+    template <class T>
+    typename std::enable_if<(std::is_integral<T>::value && std::is_signed<T>::value) ||
+                            std::is_enum<T>::value>::type
+    arg(T const value)
+    {
+        int64_t v = int64_t(value);
+        typed(Type::Int, &v, sizeof (v));
+    }
+
+    //! \brief Store an unsigned integer.
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    arg(T const value)
+    {
+        uint64_t v = uint64_t(value);
+        typed(Type::UInt, &v, sizeof (v));
+    }
+
+    //! \brief Store a float (promoted to double like printf does).
+    template <class T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    arg(T const value)
+    {
+        double v = double(value);
+        typed(Type::Double, &v, sizeof (v));
+    }
+
+    //! \brief Copy a C string (truncated if too long for the record).
+    void arg(const char* value)
+    {
+        if (value == nullptr)
+        {
+            arg(static_cast<const void*>(nullptr));
+            return ;
+        }
+        if (m_length + 2u > m_size)
+            return ;
+        m_buffer[m_length++] = char(Type::String);
+        size_t n = strnlen(value, m_size - m_length - 1u);
+        memcpy(m_buffer + m_length, value, n);
+        m_length += n;
+        m_buffer[m_length++] = '\0';
+    }
+
+    void arg(char* value)
+    {
+        arg(static_cast<const char*>(value));
+    }
+
+    //! \brief Store the address of other pointers (for %p).
+    template <class T>
+    void arg(T* value)
+    {
+        const void* v = static_cast<const void*>(value);
+        typed(Type::Pointer, &v, sizeof (v));
+    }
+
+    void arg(std::nullptr_t)
+    {
+        arg(static_cast<const void*>(nullptr));
+    }
+
+    //! \brief Return the number of bytes used.
+    size_t length() const
+    {
+        return m_length;
+    }
+
+private:
+
+    void raw(const void* data, size_t const size)
+    {
+        if (m_length + size > m_size)
+            return ;
+        memcpy(m_buffer + m_length, data, size);
+        m_length += size;
+    }
+
+    void typed(Type const type, const void* data, size_t const size)
+    {
+        if (m_length + 1u + size > m_size)
+            return ;
+        m_buffer[m_length++] = char(type);
+        raw(data, size);
+    }
+
+private:
+
+    char* m_buffer;
+    size_t const m_size;
+    size_t m_length;
+};
+
+//------------------------------------------------------------------------------
+//! \brief Encode a log statement (its identifier, its time and its printf-like
+//! arguments) into the given buffer.
+//! \return the number of bytes used.
+//------------------------------------------------------------------------------
+template <class... Args>
+size_t encode(char* buffer, size_t const size, Header const& header, Args... args)
+{
+    Encoder encoder(buffer, size);
+    encoder.header(header);
+    int expand[] = { 0, (encoder.arg(args), 0)... };
+    (void) expand;
+    return encoder.length();
+}
+
+//------------------------------------------------------------------------------
+//! \brief Same than encode() but the arguments are given by a va_list: their
+//! types are deduced from the conversions of the printf format, like
+//! vsnprintf() does.
+//! \return the number of bytes used.
+//------------------------------------------------------------------------------
+size_t vencode(char* buffer, size_t const size, Header const& header,
+               const char* format, va_list params);
+
+//------------------------------------------------------------------------------
+//! \brief Read back the header of an encoded log statement.
+//------------------------------------------------------------------------------
+inline Header header(const char* record)
+{
+    Header h;
+    memcpy(&h, record, sizeof (h));
+    return h;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Format an encoded log statement like vsnprintf() would have done.
+//! \param buffer the destination.
+//! \param size the size of the destination.
+//! \param format the printf format of the log statement.
+//! \param record the encoded log statement (see encode()).
+//! \param length the number of bytes of the encoded log statement.
+//! \return the number of chars written (without the final '\0').
+//------------------------------------------------------------------------------
+size_t format(char* buffer, size_t const size, const char* format,
+              const char* record, size_t const length);
+
+} // namespace deferred
+} // namespace mylogger
+
+#endif /* MYLOGGER_DEFERRED_HPP */
@@ -0,0 +1,187 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_FIELDS_HPP
+#  define MYLOGGER_FIELDS_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include "MyLogger/LineBuffer.hpp"
+#  include "MyLogger/Metrics.hpp"
+#  include "MyLogger/Sequence.hpp"
+#  include "MyLogger/Site.hpp"
+#  include <string>
+#  include <type_traits>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Encoding of the lines of the LOG*_KV macros.
+// *****************************************************************************
+enum class FieldFormat
+{
+    //! \brief The usual beginning of line and the message, followed by the
+    //! fields as key=value.
+    Text,
+    //! \brief One JSON object per line (JSON Lines).
+    Json,
+    //! \brief key=value pairs separated by spaces (logfmt).
+    Logfmt
+};
+
+// *****************************************************************************
+//! \brief Writer of the typed fields of a structured line (see the LOG*_KV
+//! macros) inside a LineBuffer. The time, the severity, the file and the
+//! line of the log statement and the message are fields too. Strings are
+//! escaped by a table-driven scanner copying runs of plain chars at once.
+// *****************************************************************************
+class Fields
+{
+public:
+
+    //! \brief Change the encoding of structured lines (by default: Text).
+    static void format(FieldFormat const format);
+
+    //! \brief Return the encoding of structured lines.
+    static FieldFormat format();
+
+    //! \brief Start writing fields after the first length chars of the line.
+    Fields(LineBuffer& line, size_t const length)
+        : m_line(line), m_length(length), m_format(format())
+    {}
+
+    //! \brief Write the time, the severity, the location and the message. In
+    //! Text format, only the message: the line already starts with the
+    //! beginning of line of the logger.
+    //! \return the length of the line before the fields.
+    size_t begin(Site const& site, Timestamp const& when, const char* message);
+
+    //! \brief Write the closing chars.
+    //! \return the length of the line. Room is kept for the final "\n\0".
+    size_t end();
+
+    //! \brief Write a field.
+    void add(const char* key, bool const value);
+    void add(const char* key, char const value);
+    void add(const char* key, const char* value);
+    void add(const char* key, std::string const& value);
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    add(const char* key, T const value)
+    {
+        integer(key, (value < 0) ? 0u - uint64_t(value) : uint64_t(value), value < 0);
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    add(const char* key, T const value)
+    {
+        integer(key, uint64_t(value), false);
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    add(const char* key, T const value)
+    {
+        real(key, double(value));
+    }
+
+    //! \brief Escape a string value as JSON does (logfmt uses the same
+    //! sequences). Quotes are not added. The output shall have room for 6
+    //! chars per input char.
+    //! \return the number of chars written.
+    static size_t escape(char* output, const char* input, size_t const length);
+
+private:
+
+    void integer(const char* key, uint64_t value, bool const negative);
+    void real(const char* key, double const value);
+
+    //! \brief Write the separator and the key of a field.
+    void key(const char* key);
+
+    //! \brief Write a string value, quoted and escaped.
+    void string(const char* value, size_t const length);
+
+    //! \brief Append raw chars.
+    void append(const char* data, size_t const length);
+
+    //! \brief Make room for the given number of chars (and "\n\0").
+    //! \return false if the memory is exhausted.
+    bool reserve(size_t const size)
+    {
+        return m_line.reserve(m_length + size + 2u, m_length);
+    }
+
+private:
+
+    LineBuffer& m_line;
+    size_t m_length;
+    FieldFormat const m_format;
+    //! \brief Number of fields written.
+    size_t m_count = 0u;
+    //! \brief Set when a value did not fit (out of memory).
+    bool m_truncated = false;
+};
+
+//------------------------------------------------------------------------------
+//! \brief Write the key/value pairs given to the LOG*_KV macros. The type of
+//! each value selects its Fields::add() overload at compile time. Callables
+//! without parameter are replaced by their result (see lazy::resolve()).
+//------------------------------------------------------------------------------
+inline void addFields(Fields&)
+{}
+
+template <class T, class... Args>
+void addFields(Fields& fields, const char* key, T const& value, Args const&... args)
+{
+    fields.add(key, lazy::resolve(value, 0));
+    addFields(fields, args...);
+}
+
+//------------------------------------------------------------------------------
+template <class... Args>
+void ILogger::logFields(std::ostream *stream, uint32_t const site,
+                        const char* message, Args const&... args)
+{
+    static_assert(sizeof...(Args) % 2u == 0u,
+                  "LOG*_KV expect a message followed by key/value pairs");
+
+    Metrics::Probe const probe;
+    LineBuffer line(threadBuffer(), c_buffer_size);
+    Site const& s = Sites::get(site);
+    Timestamp const now = Clock::now();
+
+    size_t n = Sequence::stamp(line.data(), c_buffer_size - 2u, now);
+    if (Fields::format() == FieldFormat::Text)
+    {
+        n += prefix(line.data() + n, c_buffer_size - 2u - n, s, now);
+    }
+    Fields fields(line, n);
+    size_t const start = fields.begin(s, now, message);
+    addFields(fields, args...);
+    n = fields.end();
+    commit(stream, s.severity, line.data(), endOfLine(line.data(), n), start);
+}
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_FIELDS_HPP */
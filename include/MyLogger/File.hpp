@@ -60,6 +60,15 @@ public:
         return path;
     }
 
+    //--------------------------------------------------------------------------
+    //! \brief Compile-time version of fileName() for string literals such as
+    //! __FILE__: return the address of the file name inside the path.
+    //--------------------------------------------------------------------------
+    constexpr static const char* baseName(const char* path)
+    {
+        return baseName(path, path);
+    }
+
     //--------------------------------------------------------------------------
     //! \brief Get the directory name of a path.
     //!
@@ -129,6 +138,18 @@ public:
         }
         return true;
     }
+
+private:
+
+    //--------------------------------------------------------------------------
+    //! \brief Recursive part of baseName(path) (C++11 constexpr functions are
+    //! a single return statement).
+    //--------------------------------------------------------------------------
+    constexpr static const char* baseName(const char* path, const char* last)
+    {
+        return (*path == '\0') ? last
+            : baseName(path + 1, ((*path == '/') || (*path == '\\')) ? path + 1 : last);
+    }
 };
 
 } // namespace namespace mylogger
@@ -0,0 +1,138 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_FLIGHTRECORDER_HPP
+#  define MYLOGGER_FLIGHTRECORDER_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include "MyLogger/Console.hpp"
+#  include <atomic>
+#  include <string>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief In-memory ring of the most recent log lines, whatever the threshold
+//! of the logger (see ILogger::threshold()), so the context of a crash is not
+//! lost. Recording a line is a single atomic increment plus a copy into its
+//! slot: writers never wait for each other. The ring is dumped into a file
+//! by Fatal and Signal lines, and by the handler of fatal signals (see
+//! installSignalHandlers()).
+//!
+//! \note Configure it before threads start logging.
+// *****************************************************************************
+class FlightRecorder
+{
+public:
+
+    //! \brief Longer lines are truncated inside the ring.
+    constexpr static size_t c_line_size = 256u;
+
+    //--------------------------------------------------------------------------
+    //! \brief Start recording the lines of the given severity or higher (by
+    //! default: all of them) into a ring of the given number of lines.
+    //! \param path the file created when the ring is dumped.
+    //! \param lines the number of lines kept (rounded up to a power of two).
+    //! \return false if the path is too long.
+    //--------------------------------------------------------------------------
+    static bool start(std::string const& path, size_t const lines = 4096u,
+                      enum Severity const severity = None);
+
+    //--------------------------------------------------------------------------
+    //! \brief Stop recording and free the ring.
+    //! \note Call it when no other thread is logging.
+    //--------------------------------------------------------------------------
+    static void stop();
+
+    //--------------------------------------------------------------------------
+    //! \brief Is the flight recorder started ?
+    //--------------------------------------------------------------------------
+    static bool active()
+    {
+        return ILogger::s_recorded.load(std::memory_order_relaxed) <= int(MaxLoggerSeverity);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Are lines of the given severity recorded ?
+    //--------------------------------------------------------------------------
+    static bool recording(enum Severity const severity)
+    {
+        return rank(severity) >= ILogger::s_recorded.load(std::memory_order_relaxed);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Also write the dumped lines on the given file descriptor (for
+    //! example 2 for the standard error), colored depending on the mode (see
+    //! Console). -1 for none, the default.
+    //--------------------------------------------------------------------------
+    static void console(int const fd, ColorMode const mode = ColorMode::Auto);
+
+    //--------------------------------------------------------------------------
+    //! \brief Store a line in the ring, overwriting the oldest one.
+    //--------------------------------------------------------------------------
+    static void record(const char* line, size_t const length,
+                       enum Severity const severity = None);
+
+    //--------------------------------------------------------------------------
+    //! \brief Write the recorded lines, oldest first, into the dump file (and
+    //! on the console, see console()). Async-signal-safe: only uses open(),
+    //! write(), writev() and close(). Lines being
+    //! written by other threads during the dump are skipped.
+    //! \return false if nothing has been dumped.
+    //--------------------------------------------------------------------------
+    static bool dump();
+
+    //--------------------------------------------------------------------------
+    //! \brief Dump the ring when the process receives SIGSEGV, SIGABRT,
+    //! SIGBUS (not on Windows), SIGFPE or SIGILL, then let the default action
+    //! of the signal terminate the process.
+    //--------------------------------------------------------------------------
+    static void installSignalHandlers();
+
+private:
+
+    //! \brief A recorded line. seq is 2 * index + 1 while the line of the
+    //! given index is being copied, and 2 * index + 2 once it is complete.
+    struct Slot
+    {
+        std::atomic<uint64_t> seq;
+        uint32_t length;
+        uint8_t severity;
+        char text[c_line_size];
+    };
+
+    //! \brief Maximum length of the path of the dump file.
+    constexpr static size_t c_max_path = 1024u;
+
+    static Slot* s_slots;
+    static uint64_t s_mask;
+    //! \brief Index of the next recorded line.
+    static std::atomic<uint64_t> s_cursor;
+    //! \brief Only one dump at a time.
+    static std::atomic<bool> s_dumping;
+    static char s_path[c_max_path];
+    //! \brief File descriptor of the console (-1 for none).
+    static std::atomic<int> s_console;
+    static std::atomic<bool> s_colored;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_FLIGHTRECORDER_HPP */
@@ -0,0 +1,209 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_GREP_HPP
+#  define MYLOGGER_GREP_HPP
+
+#  include "MyLogger/Severity.hpp"
+#  include <cstddef>
+#  include <cstdint>
+#  include <string>
+#  include <utility>
+#  include <vector>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Beginning of a line of a text log file written with the default
+//! layout (see Layout): an optional stamp (see Sequence), the time of the
+//! day, the severity tag and the location of the log statement. Example:
+//! "[12:00:00.123456][ERROR][main.cpp::12] message".
+// *****************************************************************************
+struct LineInfo
+{
+    //! \brief Time of the day in nanoseconds, -1 when the line has none
+    //! (banners, following lines of a multi-line message).
+    int64_t time;
+    //! \brief None when the line has no severity tag.
+    enum Severity severity;
+    //! \brief "file::line" without the brackets, nullptr when absent.
+    const char* location;
+    size_t location_length;
+
+    //! \brief Parse the beginning of the given line. The location is only
+    //! parsed when asked.
+    static LineInfo parse(const char* line, size_t const length,
+                          bool const location = true);
+};
+
+// *****************************************************************************
+//! \brief Sparse index of a text log file, saved next to it (see path()):
+//! the offset of each run of lines logged during the same minute, with the
+//! severities found in the run. Searches skip the runs which cannot match
+//! instead of reading them.
+//!
+//! The index only covers the whole lines present when it was updated: lines
+//! appended later are searched without index until the next update().
+// *****************************************************************************
+class LogIndex
+{
+public:
+
+    //! \brief A run of lines logged during the same minute.
+    struct Entry
+    {
+        //! \brief Offset of the first line of the run.
+        uint64_t offset;
+        //! \brief Minute of the day, -1 for the lines before the first line
+        //! with a time.
+        int32_t minute;
+        //! \brief Bit i is set when the run holds a line of severity i.
+        uint32_t severities;
+    };
+
+    //! \brief Index the lines appended since the last update, or the whole
+    //! content when it no longer starts with the indexed one (see covers()).
+    void update(const char* data, size_t const size);
+
+    //! \brief Does the given content start with the indexed content ? Checked
+    //! on the indexed size and the last indexed bytes.
+    bool covers(const char* data, size_t const size) const;
+
+    //! \brief Load the index saved in the given file.
+    //! \return false if the file is missing or is not an index.
+    bool load(std::string const& path);
+
+    //! \brief Save the index into the given file.
+    bool save(std::string const& path) const;
+
+    //! \brief Return the path of the index of the given log file:
+    //! "<log file>.idx".
+    static std::string path(std::string const& log);
+
+    //! \brief Return the number of bytes of the log file covered.
+    size_t size() const
+    {
+        return size_t(m_size);
+    }
+
+    //! \brief Return the runs of lines, in the order of the file.
+    std::vector<Entry> const& entries() const
+    {
+        return m_entries;
+    }
+
+private:
+
+    std::vector<Entry> m_entries;
+    //! \brief Number of bytes of the log file covered (whole lines).
+    uint64_t m_size = 0u;
+    //! \brief Hash of the last covered bytes (see covers()).
+    uint64_t m_check = 0u;
+};
+
+// *****************************************************************************
+//! \brief Find the lines of a text log file matching a query. Lines are
+//! never copied: the content shall outlive the search. When a text or a
+//! location is searched, the search jumps from one occurrence to the next
+//! (memmem) instead of reading the content line by line. With an index, the
+//! runs of lines which cannot match the severity or the time range are
+//! skipped.
+// *****************************************************************************
+class Grep
+{
+public:
+
+    //! \brief A day in nanoseconds.
+    constexpr static int64_t c_day = 86400000000000;
+
+    //! \brief What the lines shall match. All criteria shall match.
+    struct Query
+    {
+        //! \brief Lowest severity kept, in the order of rank() (None:
+        //! everything).
+        enum Severity severity = None;
+        //! \brief Range of times of the day kept, in nanoseconds. When from
+        //! is after to, the range goes through midnight. Lines without time
+        //! are not kept when the range is not the whole day.
+        int64_t from = 0;
+        int64_t to = c_day - 1;
+        //! \brief Lines of this source file, "main.cpp", or of this log
+        //! statement, "main.cpp::12" (empty: all).
+        std::string location;
+        //! \brief Lines containing this text (empty: all).
+        std::string text;
+    };
+
+    //! \brief A line of the content, with its '\n' if any.
+    struct Line
+    {
+        const char* text;
+        size_t length;
+    };
+
+    //! \brief Search the given content of a log file. The index is ignored
+    //! if it does not cover the content (see LogIndex::covers()).
+    Grep(const char* data, size_t const size, Query const& query,
+         LogIndex const* index = nullptr);
+
+    //! \brief Get the next matching line.
+    //! \return false when the whole content has been searched.
+    bool next(Line& line);
+
+    //! \brief Return the number of bytes skipped thanks to the index.
+    size_t skipped() const
+    {
+        return m_skipped;
+    }
+
+    //! \brief Does the given line match the query ?
+    bool match(const char* line, size_t const length) const;
+
+private:
+
+    //! \brief Can the given run of lines of the index match the query ?
+    bool selected(LogIndex::Entry const& entry) const;
+
+    //! \brief Is the given time of the day inside the range of the query ?
+    bool inRange(int64_t const time) const;
+
+    //! \brief Add a range of the content to search.
+    void region(size_t const begin, size_t const end);
+
+private:
+
+    const char* m_data;
+    Query m_query;
+    bool m_timed;
+    //! \brief Bit i is set when the severity i is kept (see LogIndex::Entry).
+    uint32_t m_severities;
+    //! \brief The text to jump to: the searched text, else the location.
+    std::string m_needle;
+    //! \brief Ranges of the content to search [begin, end[.
+    std::vector<std::pair<size_t, size_t>> m_regions;
+    size_t m_region = 0u;
+    size_t m_position = 0u;
+    size_t m_skipped = 0u;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_GREP_HPP */
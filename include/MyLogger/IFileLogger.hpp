@@ -22,14 +22,83 @@
 #  define MYLOGGER_IFILELOGGER_HPP
 
 #  include "MyLogger/ILogger.hpp"
+#  include <string>
 
 namespace mylogger {
+namespace project {
+
+struct Info
+{
+    Info() = default;
+    Info(bool const dbg, const char* name, uint32_t const major,
+         uint32_t const minor, const char* sha1, const char* branch,
+         const char* data, const char* tmp, const char* logname,
+         const char* logpath)
+        : debug(dbg),
+          project_name(name),
+          major_version(major),
+          minor_version(minor),
+          git_sha1(sha1),
+          git_branch(branch),
+          data_path(data),
+          tmp_path(tmp),
+          log_name(logname),
+          log_path(logpath)
+    {}
+
+    //! \brief Compiled in debug or released mode
+    bool debug = false;
+    //! \brief Used for logs and GUI.
+    std::string project_name;
+    //! \brief Major version of project
+    uint32_t major_version = 0u;
+    //! \brief Minor version of project
+    uint32_t minor_version = 0u;
+    //! \brief Save the git SHA1
+    std::string git_sha1;
+    //! \brief Save the git branch
+    std::string git_branch;
+    //! \brief Pathes where default project resources have been installed
+    //! (when called  by the shell command: sudo make install).
+    std::string data_path;
+    //! \brief Location for storing temporary files
+    std::string tmp_path;
+    //! \brief Give a name to the default project log file.
+    std::string log_name;
+    //! \brief Define the full path for the project.
+    std::string log_path;
+};
+
+} // namespace project
 
 // *****************************************************************************
 //!  \brief Interface class for file loggers.
 // *****************************************************************************
 class IFileLogger: public ILogger
 {
+protected:
+
+    //! \brief Return the path of the log file: when the given path has no
+    //! directory, the file is placed in info.tmp_path. Directories are
+    //! created if needed.
+    //! \return false if directories cannot be created.
+    static bool logPath(std::string const& filename, project::Info const& info,
+                        std::string& path);
+
+    //! \brief Format the banner starting the file (project name, version ...).
+    //! \return the length of the banner.
+    static size_t formatHeader(char* buffer, size_t const size, project::Info const& info);
+
+    //! \brief Format the banner ending the file.
+    //! \return the length of the banner.
+    static size_t formatFooter(char* buffer, size_t const size, project::Info const& info);
+
+    //! \brief Log the banner starting the file (project name, version ...).
+    void writeHeader(project::Info const& info);
+
+    //! \brief Log the banner ending the file.
+    void writeFooter(project::Info const& info);
+
 private:
 
     //! \brief virtual method opening the media.
@@ -21,88 +21,285 @@
 #ifndef MYLOGGER_ILOGGER_HPP
 #  define MYLOGGER_ILOGGER_HPP
 
+#  include "MyLogger/Clock.hpp"
+#  include "MyLogger/Layout.hpp"
+#  include "MyLogger/Severity.hpp"
+#  include <algorithm>
+#  include <atomic>
 #  include <mutex>
 #  include <fstream>
 #  include <sstream>
+#  include <string>
+#  include <ctime>
+#  include <cstdarg>
 
 namespace mylogger {
 
-// *****************************************************************************
-//! \brief Different severity enumerate
-// *****************************************************************************
-enum Severity
+struct Site;
+class LogLine;
+class Repeats;
+class FlightRecorder;
+
+namespace lazy {
+
+//------------------------------------------------------------------------------
+//! \brief Arguments of the LOG* macros are given as they are, except callables
+//! without parameter (for example lambdas) which are replaced by their result.
+//! They are called once the log statement has passed all filters.
+//------------------------------------------------------------------------------
+template <class T>
+inline auto resolve(T const& arg, int) -> decltype(arg())
 {
-    None, Info, Debug, Warning, Failed, Error, Signal, Exception,
-    Catch, Fatal, MaxLoggerSeverity = Fatal
-};
+    return arg();
+}
+
+template <class T>
+inline T const& resolve(T const& arg, long)
+{
+    return arg;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Give a std::string to the %s of the format as a C string.
+//------------------------------------------------------------------------------
+inline const char* value(std::string const& arg)
+{
+    return arg.c_str();
+}
+
+template <class T>
+inline T const& value(T const& arg)
+{
+    return arg;
+}
+
+} // namespace lazy
 
 // *****************************************************************************
 //! \brief Interface class for loggers.
 // *****************************************************************************
 class ILogger
 {
+    friend class LogLine;
+    friend class FlightRecorder;
+
 public:
 
     //! \brief Virtual destructor because of virtual methods.
     virtual ~ILogger() = default;
 
     //! \brief entry point for logging data. This method formats data into
-    //! m_buffer up to 1024 chars.
+    //! a buffer on the stack, or a chunk of the ChunkPool for long lines.
     void log(const char* format, ...);
 
     //! \brief entry point for logging data. This method formats data into
-    //! m_buffer.
+    //! a per-thread buffer without holding any lock. Only the hand-off of the
+    //! finished line to the media is protected (see dispatch()).
     void log(std::ostream *stream, enum Severity severity, const char* format, ...);
 
+    //! \brief entry point for the LOG* macros: the severity, the format and
+    //! the location in the source code are given by the identifier of the log
+    //! statement (see Sites::add()).
+    void log(std::ostream *stream, uint32_t const site, ...);
+
+    //! \brief entry point for the LOG_UNIQUE macro: same than log(stream,
+    //! site, ...) but a message identical to the previous one of this log
+    //! statement is only counted (see Repeats).
+    void logUnique(Repeats& repeats, std::ostream *stream, uint32_t const site, ...);
+
+    //! \brief entry point for the LOG* macros: same than log(stream, site,
+    //! ...) but arguments can also be std::string or callables without
+    //! parameter, for example [&]{ return obj.dump(); }, called only when the
+    //! statement is logged (see lazy::resolve()).
+    template <class... Args>
+    void logLazy(std::ostream *stream, uint32_t const site, Args const&... args)
+    {
+        // Results of the callables live until the end of the call to log().
+        log(stream, site, lazy::value(lazy::resolve(args, 0))...);
+    }
+
+    //! \brief Same for the LOG_UNIQUE macro (see logUnique()).
+    template <class... Args>
+    void logLazy(Repeats& repeats, std::ostream *stream, uint32_t const site,
+                 Args const&... args)
+    {
+        logUnique(repeats, stream, site, lazy::value(lazy::resolve(args, 0))...);
+    }
+
+    //! \brief entry point for the LOG*_KV macros: a message followed by
+    //! key/value pairs, written as typed fields (see Fields). Defined in
+    //! Fields.hpp.
+    template <class... Args>
+    void logFields(std::ostream *stream, uint32_t const site, const char* message,
+                   Args const&... args);
+
+    //! \brief Log that the given number of occurrences of the log statement
+    //! have been dropped by its limiter (see PerSecond).
+    void suppressed(std::ostream *stream, uint32_t const site, uint64_t const count);
+
     //! \brief entry point for logging data. This method formats data into
     //! m_buffer.
     template <class T> ILogger& operator<<(const T& tolog);
 
-    //! \brief Return the date or time get by methods currentDate() or
-    //! currentTime()
+    //! \brief Return the tag of the severity, for example "[INFO]".
+    static const char *severityName(enum Severity const severity);
+
+    //! \brief Convert a severity name, with or without brackets and in any
+    //! case ("error", "ERROR", "[ERROR]"), to its value.
+    //! \return false if the name is unknown (severity is unchanged).
+    static bool severity(const char* name, enum Severity& severity);
+
+    //! \brief Change the runtime threshold of the LOG* macros: statements
+    //! with a lower severity do nothing and their arguments are not evaluated
+    //! (unless the FlightRecorder keeps them). By default, everything is
+    //! logged. Direct calls to log() are not filtered.
+    static void threshold(enum Severity const severity)
+    {
+        s_threshold.store(int(severity), std::memory_order_relaxed);
+        s_enabled.store(std::min(rank(severity), s_recorded.load(std::memory_order_relaxed)),
+                        std::memory_order_relaxed);
+    }
+
+    //! \brief Return the runtime threshold of the LOG* macros.
+    static enum Severity threshold()
+    {
+        return Severity(s_threshold.load(std::memory_order_relaxed));
+    }
+
+    //! \brief Is the given severity above the runtime threshold ? A single
+    //! relaxed load called by the LOG* macros before evaluating arguments.
+    static bool enabled(enum Severity const severity)
+    {
+        return rank(severity) >= s_enabled.load(std::memory_order_relaxed);
+    }
+
+    //! \brief Are the LOG* statements of the given severity written by the
+    //! media ? Statements enabled only for the FlightRecorder are not.
+    static bool written(enum Severity const severity)
+    {
+        return (severity == None) ||
+               (rank(severity) >= rank(Severity(s_threshold.load(std::memory_order_relaxed))));
+    }
+
+    //! \brief Return the current time as string (see Clock::format()). The
+    //! buffer is owned by the calling thread.
     const char *strtime();
 
+    //! \brief Change the layout of the beginning of the lines (time,
+    //! severity, location ...). By default "%t%S%F" (see Layout).
+    //! \note Call it before threads start logging.
+    void layout(Layout const& layout)
+    {
+        m_layout = layout;
+    }
+
+    //! \brief Return the layout of the beginning of the lines.
+    Layout const& layout() const
+    {
+        return m_layout;
+    }
+
 protected:
 
-    //! \brief Get the current date (year, month, day). Store the date as string
-    //! inside m_buffer_time.
-    void currentDate();
+    //! \brief Get the current date (year, month, day) as string "[%Y/%m/%d]".
+    static void currentDate(char* buffer, size_t const size);
+
+    //! \brief Get the current time (hour, minute, second) as string
+    //! "[%H:%M:%S]".
+    //! \param when the time to convert (by default: now).
+    static void currentTime(char* buffer, size_t const size,
+                            time_t const when = time(nullptr));
+
+    //! \brief Format the begining of the line of the given log statement
+    //! (see Layout).
+    //! \return the number of chars written (without the final '\0').
+    size_t prefix(char* buffer, size_t const size, Site const& site, Timestamp const& when);
+
+    //! \brief Add the missing '\n' at the end of the line of the given length.
+    //! The buffer shall have room for two more chars.
+    //! \return the new length.
+    static size_t endOfLine(char* buffer, size_t length);
+
+    //! \brief Return the scratch buffer (of c_buffer_size chars) of the
+    //! calling thread for formatting a line.
+    static char* threadBuffer();
+
+    //! \brief Hand a finished line over to the media. The default
+    //! implementation calls write() while holding m_mutex.
+    //! \param prefix the length of the beginning of the line (time, severity
+    //! and location) before the message.
+    virtual void dispatch(std::ostream *stream, enum Severity const severity,
+                          const char *line, size_t const length,
+                          size_t const prefix);
+
+    //! \brief Hand a line of the LOG* macros over to the FlightRecorder, then
+    //! to the media (see dispatch()) if its severity passes the threshold.
+    //! Fatal and Signal lines dump the FlightRecorder.
+    void commit(std::ostream *stream, enum Severity const severity,
+                const char *line, size_t const length, size_t const prefix);
 
-    //! \brief Get the current time (hour, minute, second). Store the date as
-    //! string inside m_buffer_time.
-    void currentTime();
+    //! \brief Hand an encoded log statement (see deferred::encode()) over to
+    //! the media. Called instead of dispatch() by the LOG* macros when
+    //! m_encoded is set. The default implementation formats the line and
+    //! calls dispatch().
+    virtual void dispatchEncoded(std::ostream *stream, const char *record,
+                                 size_t const length);
+
+    //! \brief Format an encoded log statement (see deferred::encode()) as a
+    //! line inside the given buffer of c_buffer_size chars.
+    //! \param[out] start the length of the beginning of the line.
+    //! \return the length of the line.
+    size_t formatEncoded(char* buffer, const char *record, size_t const length,
+                         size_t& start);
 
 private:
 
+    //! \brief Format and log a LOG* statement. Drop it if repeats is given
+    //! and the message is the same than the previous one.
+    void vlog(std::ostream *stream, uint32_t const site, Repeats* repeats,
+              va_list params);
+
+    //! \brief Log a line of the given log statement with the message made
+    //! of the format and the count (for example "last message repeated %llu
+    //! times").
+    void summary(std::ostream *stream, Site const& site, const char* format,
+                 uint64_t const count);
+
     //! \brief Virtual method used for storing m_buffer in the media you wish.
     virtual void write(std::string const& message) = 0;
 
     //! \brief Virtual method used for storing m_buffer in the media you wish.
     virtual void write(const char *message, const int length = -1) = 0;
 
-    //! \brief Virtual method for formating the begining of the line log (ie.
-    //! severity, date, filename ...).
-    virtual void beginOfLine() = 0;
-
 protected:
 
-    //! \brief Max char for formating a line of logs.
+    //! \brief Max char for formating a line of logs without allocation.
+    //! Longer lines move into a chunk of the ChunkPool.
     constexpr static const uint32_t c_buffer_size = 1024u;
 
-    //! \brief Buffer used for storing a line of logs.
-    char m_buffer[c_buffer_size];
-
-    //! \brief Store date information
-    char m_buffer_time[32];
-
     //! \brief Protect write against concurrency.
     std::mutex m_mutex;
 
-    //! \brief Current log severity.
-    enum Severity m_severity = None;
-
     //! \brief Memorize the stream for the method write() when log(std::ostream*).
     std::ostream *m_stream = nullptr;
+
+    //! \brief The media stores log statements encoded instead of formatted:
+    //! the LOG* macros call dispatchEncoded() instead of dispatch().
+    std::atomic<bool> m_encoded{false};
+
+    //! \brief Layout of the beginning of the lines. Used without lock.
+    Layout m_layout;
+
+private:
+
+    //! \brief Runtime threshold of the LOG* macros.
+    static std::atomic<int> s_threshold;
+    //! \brief Rank (see rank()) of the lowest severity kept by the
+    //! FlightRecorder (above Fatal when it is not recording).
+    static std::atomic<int> s_recorded;
+    //! \brief Lowest rank of s_threshold and s_recorded: statements of lower
+    //! rank are skipped by the LOG* macros.
+    static std::atomic<int> s_enabled;
 };
 
 template <class T> ILogger& ILogger::operator<<(const T& to_log)
@@ -0,0 +1,218 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_LAYOUT_HPP
+#  define MYLOGGER_LAYOUT_HPP
+
+#  include "MyLogger/Clock.hpp"
+#  include "MyLogger/Severity.hpp"
+#  include <algorithm>
+#  include <cstddef>
+#  include <cstring>
+#  include <string>
+#  include <vector>
+
+namespace mylogger {
+
+struct Site;
+
+namespace layout {
+
+// *****************************************************************************
+//! \brief What the fields of a layout know about the line being formatted.
+// *****************************************************************************
+struct Context
+{
+    enum Severity severity;
+    //! \brief The log statement (nullptr for direct calls to ILogger::log()).
+    Site const* site;
+    Timestamp when;
+};
+
+//! \brief Copy the given text, truncated to the size.
+//! \return the number of chars written.
+inline size_t copy(char* buffer, size_t const size, const char* text, size_t const length)
+{
+    size_t const n = std::min(length, size);
+    memcpy(buffer, text, n);
+    return n;
+}
+
+// *****************************************************************************
+//! \brief Fields of a layout. Each one writes at most size chars (without
+//! final '\0') and returns the number of chars written. Pattern letters are
+//! given between parenthesis (see Layout::compile()).
+// *****************************************************************************
+
+//! \brief (%t) Local time as "[%H:%M:%S.uuuuuu]" (see Clock::format()).
+struct Time { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%T) Local time as "%H:%M:%S".
+struct Hms { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%D) Local date as "%Y/%m/%d".
+struct Date { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%e) Milliseconds of the time (3 digits).
+struct Millis { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%u) Microseconds of the time (6 digits).
+struct Micros { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%n) Nanoseconds of the time (9 digits).
+struct Nanos { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%S) Severity as "[INFO]" (see ILogger::severityName()).
+struct Tag { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%L) Severity as "INFO".
+struct Level { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%F) Location as "[file::line] " (nothing when unknown).
+struct Location { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%f) Base name of the source file (nothing when unknown).
+struct Filename { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%l) Line in the source file (nothing when unknown).
+struct Line { static size_t append(char* buffer, size_t const size, Context const& context); };
+//! \brief (%i) Identifier of the calling thread (see Sequence::thread()).
+struct Thread { static size_t append(char* buffer, size_t const size, Context const& context); };
+
+//! \brief Constant text.
+template <char C, char... Chars>
+struct Text
+{
+    static size_t append(char* buffer, size_t const size, Context const& /*context*/)
+    {
+        static const char text[] = { C, Chars... };
+        return copy(buffer, size, text, sizeof (text));
+    }
+};
+
+// *****************************************************************************
+//! \brief Fields written one after the other, chosen at compile time.
+// *****************************************************************************
+template <class... Fields>
+struct Compose
+{
+    static size_t append(char* /*buffer*/, size_t const /*size*/, Context const& /*context*/)
+    {
+        return 0u;
+    }
+};
+
+template <class Field, class... Fields>
+struct Compose<Field, Fields...>
+{
+    static size_t append(char* buffer, size_t const size, Context const& context)
+    {
+        size_t const n = Field::append(buffer, size, context);
+        return n + Compose<Fields...>::append(buffer + n, size - n, context);
+    }
+};
+
+} // namespace layout
+
+// *****************************************************************************
+//! \brief Layout of the beginning of log lines (time, severity, location ...)
+//! before the message. A pattern is parsed once into a list of specialized
+//! appenders: formatting a line only calls them in order. For a layout known
+//! at build time, Layout::of() composes the fields at compile time into a
+//! single appender.
+//!
+//! \code
+//! logger.layout(Layout("%D %T.%u %L [%f:%l] %m"));
+//! logger.layout(Layout::of<layout::Hms, layout::Text<' '>, layout::Level,
+//!                          layout::Text<' '>>());
+//! \endcode
+// *****************************************************************************
+class Layout
+{
+public:
+
+    //! \brief Appender of a layout: a field or a constant text.
+    typedef size_t (*Appender)(char* buffer, size_t const size,
+                               layout::Context const& context,
+                               const char* text, size_t const length);
+
+    //! \brief The default layout "%t%S%F": "[12:00:00.000000][INFO][main.cpp::12] ".
+    Layout();
+
+    //! \brief Layout of the given pattern. Unlike compile(), an invalid
+    //! pattern gives the default layout.
+    explicit Layout(const char* pattern);
+
+    //! \brief Parse the pattern. Letters preceded by '%' are the fields of
+    //! namespace layout (for example %T), "%%" is a '%' and the rest is
+    //! copied. The optional "%m" (the message) shall end the pattern.
+    //! \return false (and the layout is not changed) if the pattern is
+    //! invalid.
+    bool compile(const char* pattern);
+
+    //! \brief Return the layout made of the given fields (see namespace
+    //! layout), composed at compile time.
+    template <class... Fields>
+    static Layout of()
+    {
+        Layout result;
+        result.m_steps.assign(1u, Step{ &field<layout::Compose<Fields...>>, 0u, 0u });
+        result.m_text.clear();
+        return result;
+    }
+
+    //! \brief Format the beginning of a line.
+    //! \return the number of chars written (without the final '\0').
+    size_t format(char* buffer, size_t const size, layout::Context const& context) const
+    {
+        if (size == 0u)
+            return 0u;
+
+        size_t n = 0u;
+        for (auto const& it: m_steps)
+        {
+            n += it.append(buffer + n, size - 1u - n, context,
+                           m_text.data() + it.offset, it.length);
+        }
+        buffer[n] = '\0';
+        return n;
+    }
+
+private:
+
+    //! \brief Appender of a field.
+    template <class Field>
+    static size_t field(char* buffer, size_t const size, layout::Context const& context,
+                        const char* /*text*/, size_t const /*length*/)
+    {
+        return Field::append(buffer, size, context);
+    }
+
+    //! \brief Appender of a constant text.
+    static size_t literal(char* buffer, size_t const size, layout::Context const& context,
+                       const char* text, size_t const length);
+
+    struct Step
+    {
+        Appender append;
+        //! \brief Constant text of the step, inside m_text.
+        size_t offset;
+        size_t length;
+    };
+
+    std::vector<Step> m_steps;
+    //! \brief Constant texts of all the steps.
+    std::string m_text;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_LAYOUT_HPP */
@@ -0,0 +1,151 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_LINEBUFFER_HPP
+#  define MYLOGGER_LINEBUFFER_HPP
+
+#  include <atomic>
+#  include <cstddef>
+#  include <cstdint>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Pool of memory chunks for the lines too long for the buffers of
+//! ILogger::c_buffer_size chars. Chunks have a power of two size and are kept
+//! in a free list per size once released, so logging long lines again does not
+//! call malloc. Chunks may be released by another thread than the one which
+//! acquired them (see the asynchronous mode of Logger).
+// *****************************************************************************
+class ChunkPool
+{
+public:
+
+    //! \brief Smallest chunk.
+    constexpr static size_t c_min_chunk = 4096u;
+    //! \brief Released chunks are freed instead of kept when the pool
+    //! already holds this number of bytes.
+    constexpr static size_t c_max_cached = 16u * 1024u * 1024u;
+
+    //--------------------------------------------------------------------------
+    //! \brief Take a chunk of at least the given size.
+    //! \param[out] capacity the real size of the chunk.
+    //! \return nullptr if memory is exhausted.
+    //--------------------------------------------------------------------------
+    static char* acquire(size_t const size, size_t& capacity);
+
+    //--------------------------------------------------------------------------
+    //! \brief Give back a chunk returned by acquire().
+    //--------------------------------------------------------------------------
+    static void release(char* chunk, size_t const capacity);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of bytes held by released chunks.
+    //--------------------------------------------------------------------------
+    static size_t cached()
+    {
+        return s_cached.load(std::memory_order_relaxed);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of chunks allocated with malloc so far.
+    //--------------------------------------------------------------------------
+    static uint64_t allocations()
+    {
+        return s_allocations.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    //! \brief Number of chunk sizes (powers of two).
+    constexpr static size_t c_classes = 8u * sizeof (size_t);
+
+    //! \brief Heads of the free lists: the first bytes of a released chunk
+    //! hold the next one (guarded by a mutex).
+    static char* s_free[c_classes];
+    static std::atomic<size_t> s_cached;
+    static std::atomic<uint64_t> s_allocations;
+};
+
+// *****************************************************************************
+//! \brief Storage of a line being formatted. It starts in a buffer given by
+//! the caller (usually on the stack, or the buffer of the calling thread) and
+//! moves into a chunk of the ChunkPool only when the line does not fit, so
+//! short lines never allocate. The chunk goes back to the pool on destruction.
+// *****************************************************************************
+class LineBuffer
+{
+public:
+
+    //! \param buffer the initial storage (not owned).
+    //! \param size the size of the initial storage.
+    LineBuffer(char* buffer, size_t const size)
+        : m_data(buffer), m_size(size), m_inline(buffer)
+    {}
+
+    //! \brief Give the chunk back to the pool.
+    ~LineBuffer()
+    {
+        if (m_data != m_inline)
+        {
+            ChunkPool::release(m_data, m_size);
+        }
+    }
+
+    LineBuffer(LineBuffer const&) = delete;
+    LineBuffer& operator=(LineBuffer const&) = delete;
+
+    //--------------------------------------------------------------------------
+    //! \brief Make the storage at least of the given size, keeping its first
+    //! chars.
+    //! \param size the needed size.
+    //! \param used the number of chars to keep.
+    //! \return false if memory is exhausted (the storage is unchanged).
+    //--------------------------------------------------------------------------
+    bool reserve(size_t const size, size_t const used)
+    {
+        return (size <= m_size) || grow(size, used);
+    }
+
+    char* data()
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+
+    //! \brief Move the storage into a chunk (slow path of reserve()).
+    bool grow(size_t const size, size_t const used);
+
+private:
+
+    char* m_data;
+    size_t m_size;
+    char* const m_inline;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_LINEBUFFER_HPP */
@@ -0,0 +1,151 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_LOGLINE_HPP
+#  define MYLOGGER_LOGLINE_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include "MyLogger/LineBuffer.hpp"
+#  include "MyLogger/Metrics.hpp"
+#  include <cstring>
+#  include <string>
+#  include <type_traits>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Builder of a log line in the style of C++ streams, created by the
+//! CPP_LOG macro for a single statement. The line is formatted inside the
+//! builder (on the stack of the caller, without allocation for strings,
+//! characters and numbers, or inside a chunk of the ChunkPool when it grows
+//! longer than ILogger::c_buffer_size) and handed over to the logger at once when the
+//! builder is destroyed, so lines of different threads cannot interleave.
+// *****************************************************************************
+class LogLine
+{
+public:
+
+    //! \brief Start the line with its prefix (time, severity and location).
+    //! \param site the identifier of the log statement (see Sites::add()).
+    LogLine(ILogger& logger, std::ostream *stream, uint32_t const site);
+
+    //! \brief Commit the line to the logger.
+    ~LogLine();
+
+    LogLine(LogLine const&) = delete;
+    LogLine& operator=(LogLine const&) = delete;
+
+    LogLine& operator<<(const char* text)
+    {
+        return append(text, (text == nullptr) ? 0u : strlen(text));
+    }
+
+    LogLine& operator<<(std::string const& text)
+    {
+        return append(text.data(), text.size());
+    }
+
+    LogLine& operator<<(char const c)
+    {
+        return append(&c, 1u);
+    }
+
+    //! \brief Characters, like std::ostream (and not their code, so int8_t
+    //! and uint8_t are also written as characters).
+    LogLine& operator<<(signed char const c)
+    {
+        return *this << char(c);
+    }
+
+    LogLine& operator<<(unsigned char const c)
+    {
+        return *this << char(c);
+    }
+
+    LogLine& operator<<(bool const b)
+    {
+        return append(b ? "1" : "0", 1u);
+    }
+
+    LogLine& operator<<(const void* pointer);
+
+    //! \brief Signed integers.
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,
+                            LogLine&>::type
+    operator<<(T const value)
+    {
+        return integer((value < 0) ? uint64_t(0u) - uint64_t(value) : uint64_t(value),
+                       value < 0);
+    }
+
+    //! \brief Unsigned integers.
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value,
+                            LogLine&>::type
+    operator<<(T const value)
+    {
+        return integer(uint64_t(value), false);
+    }
+
+    //! \brief Floating point numbers (like std::ostream: "%g").
+    template <class T>
+    typename std::enable_if<std::is_floating_point<T>::value, LogLine&>::type
+    operator<<(T const value)
+    {
+        return real(double(value));
+    }
+
+    //! \brief Other types: slow path using their std::ostream operator.
+    template <class T>
+    typename std::enable_if<!std::is_arithmetic<T>::value, LogLine&>::type
+    operator<<(T const& value)
+    {
+        std::ostringstream stream;
+        stream << value;
+        return *this << stream.str();
+    }
+
+private:
+
+    LogLine& append(const char* data, size_t const length);
+    LogLine& integer(uint64_t value, bool const negative);
+    LogLine& real(double const value);
+
+private:
+
+    ILogger& m_logger;
+    std::ostream *m_stream;
+    enum Severity m_severity;
+    size_t m_length;
+    //! \brief Length of the time, severity and location.
+    size_t m_prefix;
+    char m_buffer[ILogger::c_buffer_size];
+    //! \brief m_buffer or, for long lines, a chunk of the ChunkPool.
+    LineBuffer m_line;
+    //! \brief Set when a value did not fit (out of memory).
+    bool m_truncated = false;
+    //! \brief Duration of the statement (see Metrics::latency()).
+    Metrics::Probe const m_probe;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_LOGLINE_HPP */
@@ -24,57 +24,54 @@
 #  include "MyLogger/Singleton.tpp"
 #  include "MyLogger/IFileLogger.hpp"
 #  include "MyLogger/File.hpp"
+#  include "MyLogger/RingBuffer.tpp"
+#  include "MyLogger/Deferred.hpp"
+#  include "MyLogger/Site.hpp"
+#  include "MyLogger/BufferedFile.hpp"
+#  include "MyLogger/Archiver.hpp"
+#  include "MyLogger/LogLine.hpp"
+#  include "MyLogger/LineBuffer.hpp"
+#  include "MyLogger/RateLimit.hpp"
+#  include "MyLogger/Sinks.hpp"
+#  include "MyLogger/Console.hpp"
+#  include "MyLogger/BinaryLog.hpp"
+#  include "MyLogger/FlightRecorder.hpp"
+#  include "MyLogger/Sequence.hpp"
+#  include "MyLogger/Fields.hpp"
+#  include "MyLogger/Metrics.hpp"
+#  include <thread>
+#  include <condition_variable>
 
 #ifndef SINGLETON_FOR_LOGGER
 #  define SINGLETON_FOR_LOGGER LongLifeSingleton<Logger>
 #endif
 
 namespace mylogger {
-namespace project {
 
-struct Info
+// *****************************************************************************
+//! \brief What an asynchronous logger does when its queue is full.
+// *****************************************************************************
+enum class QueueFullPolicy
 {
-    Info() = default;
-    Info(bool const dbg, const char* name, uint32_t const major,
-         uint32_t const minor, const char* sha1, const char* branch,
-         const char* data, const char* tmp, const char* logname,
-         const char* logpath)
-        : debug(dbg),
-          project_name(name),
-          major_version(major),
-          minor_version(minor),
-          git_sha1(sha1),
-          git_branch(branch),
-          data_path(data),
-          tmp_path(tmp),
-          log_name(logname),
-          log_path(logpath)
-    {}
-
-    //! \brief Compiled in debug or released mode
-    bool debug;
-    //! \brief Used for logs and GUI.
-    std::string project_name;
-    //! \brief Major version of project
-    uint32_t major_version;
-    //! \brief Minor version of project
-    uint32_t minor_version;
-    //! \brief Save the git SHA1
-    std::string git_sha1;
-    //! \brief Save the git branch
-    std::string git_branch;
-    //! \brief Pathes where default project resources have been installed
-    //! (when called  by the shell command: sudo make install).
-    std::string data_path;
-    //! \brief Location for storing temporary files
-    std::string tmp_path;
-    //! \brief Give a name to the default project log file.
-    std::string log_name;
-    //! \brief Define the full path for the project.
-    std::string log_path;
+    //! \brief The caller waits until the writer thread has made room.
+    Block,
+    //! \brief The new line is lost and counted by Logger::dropped().
+    Drop,
+    //! \brief The oldest queued line is lost (and counted) for the new one.
+    Overwrite
 };
 
-} // namespace project
+// *****************************************************************************
+//! \brief Encoding of the log file.
+// *****************************************************************************
+enum class FileFormat
+{
+    //! \brief Formatted lines.
+    Text,
+    //! \brief Identifier of the log statement, time delta and raw arguments
+    //! (see binary::Writer). Decode it with the mylogger-decode tool.
+    Binary
+};
 
 // *****************************************************************************
 //! \brief File Logger service. Manage a single file.
@@ -94,10 +91,130 @@ public:
     //! \brief Close the file.
     virtual ~Logger();
 
-    //! \brief Reopen the log (old content is removed).
+    //! \brief Reopen the log (old content is removed). Threads may keep on
+    //! logging meanwhile: the new file is opened and its header written before
+    //! it replaces the current one, which is closed once no thread uses it. If
+    //! the new file cannot be opened, the current one is kept.
     bool changeLog(mylogger::project::Info const& info);
     bool changeLog(std::string const& filename);
 
+    //! \brief Switch to the asynchronous mode: lines are pushed into a
+    //! lock-free queue and written into the file by a dedicated thread.
+    //! \param capacity the maximum number of queued lines (rounded up to a
+    //! power of two).
+    //! \param policy what to do when the queue is full.
+    //! \note Call it before threads start logging.
+    void startAsync(size_t const capacity = 1024u,
+                    QueueFullPolicy const policy = QueueFullPolicy::Block);
+
+    //! \brief Write all pending lines, stop the writer thread and come back to
+    //! the synchronous mode.
+    //! \note Call it when no other thread is logging.
+    void stopAsync();
+
+    //! \brief Same than log(stream, site, ...) but, in asynchronous mode, the
+    //! formatting is done by the writer thread: the caller only copies the
+    //! identifier of the log statement, the time and the raw values of the
+    //! arguments inside the queue.
+    //! \note Only arguments accepted by printf are allowed, plus std::string
+    //! and callables without parameter like logLazy(): callables are called
+    //! by the caller before the encoding. While the FlightRecorder is
+    //! recording, lines are formatted by the caller.
+    template <class... Args>
+    void logDeferred(std::ostream *stream, uint32_t const site, Args const&... args)
+    {
+        if ((m_queue == nullptr) || FlightRecorder::active())
+        {
+            logLazy(stream, site, args...);
+            return ;
+        }
+
+        Metrics::Probe const probe;
+        deferred::Header const header = { site, Clock::now() };
+        uint32_t length = 0u;
+        push([&](Record& record)
+        {
+            record.stream = stream;
+            record.deferred = true;
+            record.chunk = nullptr;
+            record.length = uint32_t(deferred::encode(record.data, c_buffer_size,
+                                                      header,
+                                                      lazy::value(lazy::resolve(args, 0))...));
+            length = record.length;
+        });
+        Metrics::line(Sites::get(site).severity, length);
+    }
+
+    //! \brief Will a line of the given severity reach the media ? False in
+    //! asynchronous mode when the queue is full and its policy is Drop: the
+    //! line is counted as dropped without being formatted, unless the
+    //! FlightRecorder records it. Called by the LOG* macros before evaluating
+    //! arguments.
+    bool accepts(enum Severity const severity)
+    {
+        if ((m_queue == nullptr) || (m_policy != QueueFullPolicy::Drop) ||
+            !m_queue->full() ||
+            FlightRecorder::recording(severity))
+        {
+            return true;
+        }
+
+        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+        Metrics::line(severity, 0u);
+        Metrics::dropped();
+        return false;
+    }
+
+    //! \brief Change when the lines are written into the file. By default,
+    //! each line is written immediately in synchronous mode and, in
+    //! asynchronous mode, lines are buffered up to 64 KiB or one second (the
+    //! writer thread flushes them when idle) and Error lines (or higher) are
+    //! written immediately.
+    //! \note In synchronous mode, the interval of the given policy is only
+    //! checked when a new line is written: without new lines, the buffered
+    //! ones wait for the next flush or for the closure of the file.
+    void flushPolicy(FlushPolicy const& policy);
+
+    //! \brief Change when the log file is rotated. By default, the file is
+    //! never rotated. Old files are renamed and compressed by a background
+    //! thread.
+    void rotationPolicy(RotationPolicy const& policy);
+
+    //! \brief Change the encoding of the log file. Takes effect when the
+    //! file is (re)opened by changeLog(). In binary mode, the console and the
+    //! sinks still receive formatted lines.
+    void fileFormat(FileFormat const format)
+    {
+        m_format = format;
+    }
+
+    //! \brief Add an output to the logger. Lines are formatted once and given
+    //! to the file then to each sink. Wrap slow sinks inside an AsyncSink.
+    void addSink(std::shared_ptr<ISink> const& sink);
+
+    //! \brief Remove an output of the logger.
+    void removeSink(std::shared_ptr<ISink> const& sink);
+
+    //! \brief Change when the lines of the LOG*S macros (written on the
+    //! standard output or error) are colored. By default, only on a terminal.
+    void consoleColors(ColorMode const mode);
+
+    //! \brief Return the number of lines lost because of a full queue.
+    uint64_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    //! \brief Return a snapshot of the metrics of the logging (shared by all
+    //! the loggers of the process) and the depth of the queue of this one.
+    //! \note Do not call it while stopAsync() is running.
+    Stats stats() const;
+
+    //! \brief Write the metrics (see stats()) as a "[STATS]" line into the
+    //! log file every given period (0 to stop). The period is checked when a
+    //! line is written and, in asynchronous mode, by the idle writer thread.
+    void statsPeriod(std::chrono::milliseconds const period);
+
     //! \brief Log in the style of C++.
     ILogger& operator<<(const Severity& severity);
 
@@ -106,10 +223,13 @@ public:
 
 private:
 
-    //! \brief Open the file.
+    struct Target;
+
+    //! \brief Open the file and make it the current one. Called with
+    //! m_reconfig held.
     virtual bool open(std::string const& filename) override;
 
-    //! \brief Close the file.
+    //! \brief Close the current file. Called with m_reconfig held.
     virtual void close() override;
 
     //! \brief Write in the file.
@@ -121,40 +241,270 @@ private:
     //! \brief Write in the file.
     virtual void write(const char *message, const int length = -1) override;
 
-    //! \brief Write the header of the file.
+    //! \brief Give the header of the current file to the sinks (the file
+    //! got it when opened). Called with m_mutex held.
     virtual void header() override;
 
-    //! \brief Write the footer of the file.
+    //! \brief Give the footer of the current file to the sinks (the file gets
+    //! it when retired). Called with m_mutex held.
     virtual void footer() override;
 
-    //! \brief Format the begining of log lines.
-    virtual void beginOfLine() override;
+    //! \brief Push the line into the queue when asynchronous, else write it
+    //! while holding the mutex.
+    virtual void dispatch(std::ostream *stream, enum Severity const severity,
+                          const char *line, size_t const length,
+                          size_t const prefix) override;
+
+    //! \brief Push the encoded log statement into the queue when asynchronous,
+    //! else write it while holding the mutex.
+    virtual void dispatchEncoded(std::ostream *stream, const char *record,
+                                 size_t const length) override;
+
+    //! \brief Write a line in the console stream (if any), in the current file
+    //! and in the sinks. Called with m_mutex held.
+    void output(std::ostream *stream, enum Severity const severity,
+                const char *line, size_t const length, size_t const prefix);
+
+    //! \brief Write an encoded log statement in the file. Format it only if
+    //! the console stream or the sinks need it.
+    void outputEncoded(std::ostream *stream, const char *record, size_t const length);
+
+    //! \brief Write a line in the console stream (if any) and in the sinks.
+    void broadcast(std::ostream *stream, enum Severity const severity,
+                   const char *line, size_t const length, size_t const prefix);
+
+    //! \brief Write a formatted text in the given file, in its format.
+    static void store(Target& target, const char *text, size_t const length,
+                      enum Severity const severity);
+
+    //! \brief Write the "[STATS]" line into the file when the period set by
+    //! statsPeriod() has elapsed. Called with m_mutex held.
+    void dumpStats(Target& target);
+
+    //! \brief Lock m_mutex, counting the time spent waiting for it.
+    std::unique_lock<std::mutex> acquire();
+
+    //! \brief Close the file with its footer and open a new file with its
+    //! header under a fresh name: the archiver thread gives it the log path.
+    //! Called with m_mutex held.
+    void rotate(Target& target);
+
+    //! \brief Flush policy of the files: the one given to flushPolicy(), else
+    //! one write per line in synchronous mode since no thread would flush the
+    //! lines once the interval has elapsed. Called with m_reconfig held.
+    FlushPolicy filePolicy() const;
+
+    //! \brief Create the directories, open the file and write its header,
+    //! without disturbing the threads logging into the current file: m_mutex
+    //! is not taken. Called with m_reconfig held.
+    //! \return nullptr if the file cannot be opened.
+    Target* prepare(std::string const& filename);
+
+    //! \brief Replace the current file by the given one (nullptr for none)
+    //! then retire the previous one. Called with m_reconfig held.
+    void publish(Target* next);
+
+    //! \brief Write the footer of a file no longer used by any thread, close
+    //! and delete it.
+    static void retire(Target* target);
+
+    //! \brief Push a line into the queue of the writer thread.
+    void enqueue(std::ostream *stream, enum Severity const severity,
+                 const char *message, size_t const length, size_t const prefix);
+
+    //! \brief Fill a record of the queue with the given functor, applying the
+    //! QueueFullPolicy when the queue is full.
+    template <class Fn>
+    void push(Fn&& fill)
+    {
+        switch (m_policy)
+        {
+        case QueueFullPolicy::Block:
+            if (!m_queue->push(fill))
+            {
+                uint64_t const start = Metrics::now();
+                do
+                {
+                    m_wakeup.notify_one();
+                    std::this_thread::yield();
+                } while (!m_queue->push(fill));
+                Metrics::queueWait(Metrics::now() - start);
+            }
+            break;
+        case QueueFullPolicy::Drop:
+            if (!m_queue->push(fill))
+            {
+                m_dropped.fetch_add(1u, std::memory_order_relaxed);
+                Metrics::dropped();
+            }
+            break;
+        case QueueFullPolicy::Overwrite:
+            while (!m_queue->push(fill))
+            {
+                if (m_queue->pop([](Record& record)
+                    { ChunkPool::release(record.chunk, record.capacity); }))
+                {
+                    m_dropped.fetch_add(1u, std::memory_order_relaxed);
+                    Metrics::dropped();
+                }
+            }
+            break;
+        }
+
+        m_wakeup.notify_one();
+    }
+
+    //! \brief Wait until the writer thread has written all queued lines.
+    void drain();
+
+    //! \brief Body of the writer thread.
+    void consume();
 
 private:
 
+    //! \brief A line waiting in the queue for the writer thread.
+    struct Record
+    {
+        //! \brief Optional console stream (see ILogger::log(std::ostream*)).
+        std::ostream *stream;
+        //! \brief data holds an encoded log statement (see logDeferred())
+        //! instead of a formatted line.
+        bool deferred;
+        //! \brief Severity of formatted lines (deferred ones use their site).
+        uint8_t severity;
+        //! \brief Length of the prefix of formatted lines.
+        uint16_t prefix;
+        uint32_t length;
+        char data[c_buffer_size];
+        //! \brief Lines longer than data are copied into a chunk of the
+        //! ChunkPool, given back by the writer thread (nullptr if unused).
+        char* chunk;
+        size_t capacity;
+    };
+
+    //! \brief An opened log file. The current one is published to the
+    //! threads by the atomic pointer m_target and only used while holding
+    //! m_mutex: once changeLog() has swapped the pointer, taking m_mutex once
+    //! is enough to know that nobody uses the previous file any more.
+    struct Target
+    {
+        project::Info info;
+        //! \brief Path of the opened file.
+        std::string path;
+        BufferedFile file;
+        //! \brief Encoder of the binary file.
+        binary::Writer binary;
+        //! \brief The file is binary (see FileFormat).
+        bool encoded = false;
+    };
+
+    //! \brief Information of the next opened file (guarded by m_reconfig).
     project::Info m_info;
-    std::ofstream m_file;
+    //! \brief Current file (nullptr when closed).
+    std::atomic<Target*> m_target{nullptr};
+    //! \brief Serialize changeLog() calls, never the threads logging.
+    std::mutex m_reconfig;
+    //! \brief Flush policy of the next opened files (guarded by m_reconfig,
+    //! like m_info: read by prepare() without taking m_mutex).
+    FlushPolicy m_flush;
+    //! \brief flushPolicy() has been called (guarded by m_reconfig).
+    bool m_flush_set = false;
+    //! \brief Encoding of the next opened file.
+    FileFormat m_format = FileFormat::Text;
+    //! \brief Rotate the file and archive old files.
+    Archiver m_archiver;
+    //! \brief Other outputs (guarded by m_mutex).
+    std::vector<std::shared_ptr<ISink>> m_sinks;
+    //! \brief Lines given to std::cout and std::cerr are written directly on
+    //! their file descriptor (guarded by m_mutex).
+    Console m_stdout{1};
+    Console m_stderr{2};
+    //! \brief Period of the "[STATS]" lines in milliseconds (0: none).
+    std::atomic<int64_t> m_stats_period{0};
+    //! \brief Time of the last "[STATS]" line (guarded by m_mutex).
+    std::chrono::steady_clock::time_point m_stats_last;
+
+    //! \brief Queue of lines. nullptr when the logger is synchronous.
+    std::unique_ptr<RingBuffer<Record>> m_queue;
+    QueueFullPolicy m_policy = QueueFullPolicy::Block;
+    //! \brief Thread writing queued lines into the current file.
+    std::thread m_writer;
+    std::atomic<bool> m_running{false};
+    //! \brief The writer thread is popping lines.
+    std::atomic<bool> m_busy{false};
+    std::atomic<uint64_t> m_dropped{0u};
+    //! \brief Wake up the writer thread or the threads waiting for the drain.
+    std::mutex m_wakeup_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_drained;
 };
 
-// FIXME dans ::instance()
-#  define SHORT_FILENAME mylogger::File::fileName(__FILE__).c_str()
+//! \brief Compile with -DMYLOGGER_DEFERRED_FORMATTING to let the writer thread
+//! of the asynchronous mode format the lines instead of the caller.
+#  if defined(MYLOGGER_DEFERRED_FORMATTING)
+#    define MYLOGGER_LOG logDeferred
+#  else
+#    define MYLOGGER_LOG logLazy
+#  endif
+
+//! \brief Base name of the current source file, computed at compile time.
+#  define SHORT_FILENAME mylogger::File::baseName(__FILE__)
 
 #  define CONFIG_LOG(info) mylogger::Logger::instance().changeLog(info)
 
-// FIXME a desactiver when NDEBUG
-//! \brief Log C++ like. Example:  CPP_LOG(mylogger::Fatal) << "test\n";
+
+//! \brief Compile with -DMYLOGGER_MIN_SEVERITY=mylogger::Warning (for
+//! example) to remove the LOG* statements of lower severity (in the order of
+//! rank(), where Debug is below Info) from the code. LOGB is never removed.
+#  if !defined(MYLOGGER_MIN_SEVERITY)
+#    define MYLOGGER_MIN_SEVERITY mylogger::None
+#  endif
+
+//! \brief Is a log statement of the given severity compiled and above the
+//! runtime threshold (see ILogger::threshold()) or kept by the FlightRecorder ?
+//! The first test is a constant: the optimizer removes disabled statements.
+#  define MYLOGGER_ENABLED(severity)                                    \
+    (((severity) == mylogger::None) ||                                  \
+     ((mylogger::rank(severity) >= mylogger::rank(MYLOGGER_MIN_SEVERITY)) && \
+      mylogger::ILogger::enabled(severity)))
+
+//! \brief Is a log statement of the given severity enabled (see
+//! MYLOGGER_ENABLED) and would its line be kept by the logger (see
+//! Logger::accepts()) ? Checked before evaluating the arguments.
+#  define MYLOGGER_ACCEPTED(severity)                                   \
+    (MYLOGGER_ENABLED(severity) && mylogger::Logger::instance().accepts(severity))
+
+//! \brief Register the log statement once (severity, file, line and format)
+//! and call the logger with its identifier. Arguments are only evaluated
+//! when the line is accepted (see MYLOGGER_ACCEPTED), and callables given as
+//! arguments are only called then (see ILogger::logLazy()).
+#  define MYLOGGER_LOG_SITE(stream, severity, file, format, ...)        \
+    do {                                                                \
+        if (MYLOGGER_ACCEPTED(severity)) {                              \
+            static const uint32_t mylogger_site =                       \
+                mylogger::Sites::add(severity, file, __LINE__, format); \
+            mylogger::Logger::instance().MYLOGGER_LOG(stream, mylogger_site, __VA_ARGS__); \
+        }                                                               \
+    } while (0)
+
+//! \brief Log C++ like. Example: CPP_LOG(mylogger::Fatal) << "test " << 42;
+//! The whole line is handed over to the logger at the end of the statement.
+//! The severity shall be a constant. Filtered like the other LOG* macros.
 #  define CPP_LOG(severity, ...)                                        \
-    mylogger::Logger::instance() << mylogger::Logger::instance().strtime(); \
-    mylogger::Logger::instance() << severity << '[' << SHORT_FILENAME << "::" << __LINE__ << "] "
+    if (!MYLOGGER_ACCEPTED(severity)) {} else                           \
+        mylogger::LogLine(mylogger::Logger::instance(), nullptr, [&]() { \
+            static const uint32_t mylogger_site =                       \
+                mylogger::Sites::add(severity, SHORT_FILENAME, __LINE__, ""); \
+            return mylogger_site; }())
 
 //! \brief Basic log without severity or file and line information. 'B' for Basic.
 #  define LOGB_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::None, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::None, nullptr, format, __VA_ARGS__)
 #  define LOGB(...) LOGB_HELPER(__VA_ARGS__, "")
 
 //! \brief Information Log.
 #  define LOGI_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Info, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Info, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGI(...) LOGI_HELPER(__VA_ARGS__, "")
 
 //! \brief Debug Log.
@@ -162,77 +512,153 @@ private:
 #    define LOGD(...) {}
 #  else
 #    define LOGD_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Debug, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Debug, SHORT_FILENAME, format, __VA_ARGS__)
 #    define LOGD(...) LOGD_HELPER(__VA_ARGS__, "")
 #  endif
 
 //! \brief Warning Log.
 #  define LOGW_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Warning, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Warning, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGW(...) LOGW_HELPER(__VA_ARGS__, "")
 
 //! \brief Failure Log.
 #  define LOGF_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Failed, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Failed, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGF(...) LOGF_HELPER(__VA_ARGS__, "")
 
 //! \brief Error Log.
 #  define LOGE_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Error, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Error, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGE(...) LOGE_HELPER(__VA_ARGS__, "")
 
 //! \brief Throw signal Log.
 #  define LOGS_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Signal, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Signal, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGS(...) LOGS_HELPER(__VA_ARGS__, "")
 
 //! \brief Throw exception Log.
 #  define LOGX_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Exception, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Exception, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGX(...) LOGX_HELPER(__VA_ARGS__, "")
 
 //! \brief Catch exception Log.
 #  define LOGC_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Catch, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Catch, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGC(...) LOGC_HELPER(__VA_ARGS__, "")
 
 //! \brief Fatal Log.
 #  define LOGA_HELPER(format, ...)                                      \
-    do { mylogger::Logger::instance().log(nullptr, mylogger::Fatal, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(nullptr, mylogger::Fatal, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGA(...) LOGA_HELPER(__VA_ARGS__, "")
 
 #  define LOGIS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cout, mylogger::Info, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cout, mylogger::Info, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGIS(...) LOGIS_HELPER(__VA_ARGS__, "")
 
 #  define LOGDS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cout, mylogger::Debug, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cout, mylogger::Debug, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGDS(...) LOGDS_HELPER(__VA_ARGS__, "")
 
 #  define LOGWS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cerr, mylogger::Warning, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cerr, mylogger::Warning, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGWS(...) LOGWS_HELPER(__VA_ARGS__, "")
 
 #  define LOGFS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cerr, mylogger::Failed, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cerr, mylogger::Failed, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGFS(...) LOGFS_HELPER(__VA_ARGS__, "")
 
 #  define LOGES_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cerr, mylogger::Error, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cerr, mylogger::Error, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGES(...) LOGES_HELPER(__VA_ARGS__, "")
 
 #  define LOGXS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cerr, mylogger::Exception, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cerr, mylogger::Exception, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGXS(...) LOGXS_HELPER(__VA_ARGS__, "")
 
 #  define LOGCS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cerr, mylogger::Catch, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cerr, mylogger::Catch, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGCS(...) LOGCS_HELPER(__VA_ARGS__, "")
 
 #  define LOGAS_HELPER(format, ...)                                     \
-    do { mylogger::Logger::instance().log(&std::cerr, mylogger::Fatal, "[%s::%d] " format, SHORT_FILENAME, __LINE__, __VA_ARGS__); } while (0)
+    MYLOGGER_LOG_SITE(&std::cerr, mylogger::Fatal, SHORT_FILENAME, format, __VA_ARGS__)
 #  define LOGAS(...) LOGAS_HELPER(__VA_ARGS__, "")
 
+//! \brief Same than MYLOGGER_LOG_SITE but each occurrence is first checked
+//! by a limiter of the given class (see EveryN and PerSecond) created once
+//! for the log statement: a single atomic operation, without lock nor lookup.
+//! Arguments of dropped occurrences are not evaluated.
+#  define MYLOGGER_LOG_LIMITED(limiter, n, stream, severity, file, format, ...) \
+    do {                                                                \
+        if (MYLOGGER_ACCEPTED(severity)) {                              \
+            static const uint32_t mylogger_site =                       \
+                mylogger::Sites::add(severity, file, __LINE__, format); \
+            static mylogger::limiter mylogger_limiter(n);               \
+            uint64_t mylogger_suppressed;                               \
+            if (mylogger_limiter.allow(mylogger_suppressed)) {          \
+                if (mylogger_suppressed != 0u) {                        \
+                    mylogger::Logger::instance().suppressed(stream, mylogger_site, \
+                                                            mylogger_suppressed); \
+                }                                                       \
+                mylogger::Logger::instance().MYLOGGER_LOG(stream, mylogger_site, __VA_ARGS__); \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+//! \brief Log only the first of every n occurrences of this statement.
+//! Example: LOG_EVERY_N(mylogger::Warning, 100, "Queue full: %d", size);
+#  define LOG_EVERY_N_HELPER(severity, n, format, ...)                  \
+    MYLOGGER_LOG_LIMITED(EveryN, n, nullptr, severity, SHORT_FILENAME, format, __VA_ARGS__)
+#  define LOG_EVERY_N(severity, n, ...) LOG_EVERY_N_HELPER(severity, n, __VA_ARGS__, "")
+
+//! \brief Log at most n occurrences of this statement per second. The number
+//! of dropped occurrences is logged before the next logged one.
+#  define LOG_PER_SECOND_HELPER(severity, n, format, ...)               \
+    MYLOGGER_LOG_LIMITED(PerSecond, n, nullptr, severity, SHORT_FILENAME, format, __VA_ARGS__)
+#  define LOG_PER_SECOND(severity, n, ...) LOG_PER_SECOND_HELPER(severity, n, __VA_ARGS__, "")
+
+//! \brief Collapse consecutive identical messages of this statement into a
+//! "last message repeated K times" line, logged before the next different
+//! message.
+#  define LOG_UNIQUE_HELPER(severity, format, ...)                      \
+    do {                                                                \
+        if (MYLOGGER_ACCEPTED(severity)) {                              \
+            static const uint32_t mylogger_site =                       \
+                mylogger::Sites::add(severity, SHORT_FILENAME, __LINE__, format); \
+            static mylogger::Repeats mylogger_repeats;                  \
+            mylogger::Logger::instance().logLazy(mylogger_repeats, nullptr, \
+                                                 mylogger_site, __VA_ARGS__); \
+        }                                                               \
+    } while (0)
+#  define LOG_UNIQUE(severity, ...) LOG_UNIQUE_HELPER(severity, __VA_ARGS__, "")
+
+//! \brief Log a message followed by typed fields given as key/value pairs,
+//! written as text, JSON Lines or logfmt (see Fields::format()). Example:
+//! LOGI_KV("request done", "user", id, "latency_us", 12.5);
+//! Arguments are only evaluated when the severity is enabled.
+#  define MYLOGGER_LOG_FIELDS(stream, severity, file, ...)              \
+    do {                                                                \
+        if (MYLOGGER_ACCEPTED(severity)) {                              \
+            static const uint32_t mylogger_site =                       \
+                mylogger::Sites::add(severity, file, __LINE__, "");     \
+            mylogger::Logger::instance().logFields(stream, mylogger_site, __VA_ARGS__); \
+        }                                                               \
+    } while (0)
+
+#  define LOGI_KV(...)                                                  \
+    MYLOGGER_LOG_FIELDS(nullptr, mylogger::Info, SHORT_FILENAME, __VA_ARGS__)
+#  if defined(NDEBUG)
+#    define LOGD_KV(...) {}
+#  else
+#    define LOGD_KV(...)                                                \
+    MYLOGGER_LOG_FIELDS(nullptr, mylogger::Debug, SHORT_FILENAME, __VA_ARGS__)
+#  endif
+#  define LOGW_KV(...)                                                  \
+    MYLOGGER_LOG_FIELDS(nullptr, mylogger::Warning, SHORT_FILENAME, __VA_ARGS__)
+#  define LOGF_KV(...)                                                  \
+    MYLOGGER_LOG_FIELDS(nullptr, mylogger::Failed, SHORT_FILENAME, __VA_ARGS__)
+#  define LOGE_KV(...)                                                  \
+    MYLOGGER_LOG_FIELDS(nullptr, mylogger::Error, SHORT_FILENAME, __VA_ARGS__)
+
 } // namespace mylogger
 
 #endif /* MYLOGGER_LOGGER_HPP */
@@ -0,0 +1,115 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_MERGER_HPP
+#  define MYLOGGER_MERGER_HPP
+
+#  include "MyLogger/Sequence.hpp"
+#  include <deque>
+#  include <functional>
+#  include <queue>
+#  include <vector>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Merge the contents of several log files (or segments of a rotated
+//! file) into a single stream of lines ordered by their stamp (see Sequence).
+//! Lines are never copied: the contents shall outlive the merger. Lines
+//! without stamp (banners, following lines of a multi-line message) stay
+//! after the previous stamped line of their file.
+//!
+//! Inputs are expected to be nearly sorted: a window of lines is read ahead
+//! in each input and reordered, so memory does not depend on the size of the
+//! inputs. A line further than the window from its place is written late.
+// *****************************************************************************
+class Merger
+{
+public:
+
+    //! \brief A line (and its following lines without stamp) of an input.
+    struct Line
+    {
+        //! \brief Index of the input (in the order of add()).
+        size_t input;
+        const char* text;
+        size_t length;
+        //! \brief Length of the stamp starting the text (0 if none).
+        size_t stamp;
+    };
+
+    //! \param window the number of lines read ahead in each input.
+    explicit Merger(size_t const window = 1024u);
+
+    //! \brief Add the content of a log file.
+    void add(const char* data, size_t const size);
+
+    //! \brief Get the next line in time order.
+    //! \return false when all the inputs have been read.
+    bool next(Line& line);
+
+    //! \brief Return the offset in the given input before which all lines
+    //! have been returned by next(): the memory before can be released.
+    size_t consumed(size_t const input) const;
+
+private:
+
+    //! \brief A line read ahead.
+    struct Entry
+    {
+        Stamp stamp;
+        //! \brief Rank of the line in its input.
+        uint64_t rank;
+        size_t offset;
+        Line line;
+
+        bool operator>(Entry const& other) const;
+    };
+
+    //! \brief Reading position in an input.
+    struct Cursor
+    {
+        const char* data;
+        size_t size;
+        size_t position;
+        //! \brief Stamp given to lines without stamp.
+        Stamp last;
+        //! \brief Lines read ahead (offset and returned by next()), from
+        //! the line of rank first.
+        std::deque<std::pair<size_t, bool>> pending;
+        uint64_t first;
+    };
+
+    //! \brief Read the next line of the given input into the window.
+    //! \return false at the end of the input.
+    bool read(size_t const input);
+
+private:
+
+    size_t m_window;
+    std::vector<Cursor> m_cursors;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> m_entries;
+    bool m_started = false;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_MERGER_HPP */
@@ -0,0 +1,174 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_METRICS_HPP
+#  define MYLOGGER_METRICS_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include <atomic>
+#  include <chrono>
+#  include <cstddef>
+#  include <cstdint>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Histogram of durations with a constant relative precision (in the
+//! style of HDR histograms): durations are grouped by power of two, each
+//! power being split into c_sub_buckets linear buckets (about 6% of
+//! precision). From 1 ns to about 18 minutes.
+// *****************************************************************************
+struct Histogram
+{
+    constexpr static size_t c_sub_bits = 4u;
+    constexpr static size_t c_sub_buckets = size_t(1) << c_sub_bits;
+    constexpr static size_t c_max_bits = 40u;
+    constexpr static size_t c_buckets = (c_max_bits - c_sub_bits + 1u) * c_sub_buckets;
+
+    //! \brief Return the bucket of the given duration in nanoseconds.
+    static size_t bucket(uint64_t const ns);
+
+    //! \brief Return the highest duration of the given bucket.
+    static uint64_t highest(size_t const bucket);
+};
+
+// *****************************************************************************
+//! \brief Snapshot of the metrics of the logger (see Logger::stats()).
+// *****************************************************************************
+struct Stats
+{
+    //! \brief Lines handed over to the media, per severity.
+    uint64_t lines[MaxLoggerSeverity + 1] = {};
+    //! \brief Bytes handed over to the media.
+    uint64_t bytes = 0u;
+    //! \brief write() system calls of the log files.
+    uint64_t flushes = 0u;
+    //! \brief Lines truncated because of a lack of memory or of room in the
+    //! queue.
+    uint64_t truncated = 0u;
+    //! \brief Lines lost because of a full queue.
+    uint64_t dropped = 0u;
+    //! \brief Time spent waiting for the mutex of the logger, in nanoseconds.
+    uint64_t mutex_wait = 0u;
+    //! \brief Time spent waiting for room in the queue, in nanoseconds.
+    uint64_t queue_wait = 0u;
+    //! \brief Number of lines in the queue of the asynchronous mode.
+    size_t queue_depth = 0u;
+    //! \brief Durations of the log statements, in nanoseconds (see
+    //! Metrics::latency()).
+    uint64_t latency[Histogram::c_buckets] = {};
+
+    //! \brief Return the total number of lines.
+    uint64_t total() const;
+
+    //! \brief Return the duration (in nanoseconds) under which the given
+    //! ratio (from 0 to 1) of the log statements were done.
+    uint64_t percentile(double const ratio) const;
+
+    //! \brief Format the snapshot as key=value pairs.
+    //! \return the number of chars written (without the final '\0').
+    size_t format(char* buffer, size_t const size) const;
+};
+
+// *****************************************************************************
+//! \brief Counters of the cost of logging. Each thread updates its own
+//! counters (a relaxed load and store, no atomic read-modify-write, no lock);
+//! they are only summed when a snapshot is asked. Counters of terminated
+//! threads are kept. Counters are shared by all the loggers of the process.
+// *****************************************************************************
+class Metrics
+{
+public:
+
+    //! \brief Start (or stop) measuring the duration of each log statement.
+    //! Disabled by default: it costs two reads of the clock per statement.
+    static void latency(bool const enable);
+
+    //! \brief Is the duration of log statements measured ?
+    static bool latency()
+    {
+        return s_latency.load(std::memory_order_relaxed);
+    }
+
+    //! \brief Count a line handed over to the media.
+    static void line(enum Severity const severity, size_t const bytes);
+
+    //! \brief Count a write() system call of a log file.
+    static void flush();
+
+    //! \brief Count a truncated line.
+    static void truncated();
+
+    //! \brief Count a line lost because of a full queue.
+    static void dropped();
+
+    //! \brief Count the time spent waiting for the mutex of the logger.
+    static void mutexWait(uint64_t const ns);
+
+    //! \brief Count the time spent waiting for room in the queue.
+    static void queueWait(uint64_t const ns);
+
+    //! \brief Add the duration of a log statement to the histogram.
+    static void record(uint64_t const ns);
+
+    //! \brief Sum the counters of all the threads.
+    static void collect(Stats& stats);
+
+    //! \brief Return the current time for measuring durations.
+    static uint64_t now()
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // *************************************************************************
+    //! \brief Measure the duration of a log statement, from its creation to
+    //! its destruction, when Metrics::latency() is enabled.
+    // *************************************************************************
+    class Probe
+    {
+    public:
+
+        Probe()
+            : m_start(latency() ? now() : 0u)
+        {}
+
+        ~Probe()
+        {
+            if (m_start != 0u)
+            {
+                record(now() - m_start);
+            }
+        }
+
+    private:
+
+        uint64_t const m_start;
+    };
+
+private:
+
+    static std::atomic<bool> s_latency;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_METRICS_HPP */
@@ -0,0 +1,136 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_MMAPLOGGER_HPP
+#  define MYLOGGER_MMAPLOGGER_HPP
+
+#  include "MyLogger/IFileLogger.hpp"
+#  include <atomic>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief File logger writing lines directly inside memory-mapped segments of
+//! the file. Each thread reserves the bytes of its line with an atomic
+//! fetch-add on the file cursor, then copies the line: no lock and no system
+//! call on the hot path. Segments are pre-allocated and mapped on demand, and
+//! unmapped once fully written. On close, the file is truncated to the real
+//! length of the log.
+//!
+//! \note Not available on Windows.
+// *****************************************************************************
+class MmapLogger: public IFileLogger
+{
+public:
+
+    //! \brief Default size of the mapped segments.
+    constexpr static size_t c_segment_size = 16u * 1024u * 1024u;
+
+    //! \brief Do not open the file.
+    //! \param segment_size the size of mapped segments (rounded up to the page
+    //! size).
+    MmapLogger(size_t const segment_size = c_segment_size);
+
+    //! \brief Open the file.
+    //! \param info structure holding all project information (name, version ...)
+    //! \param segment_size the size of mapped segments.
+    MmapLogger(project::Info const& info, size_t const segment_size = c_segment_size);
+
+    //! \brief Close the file.
+    virtual ~MmapLogger();
+
+    //! \brief Reopen the log (old content is removed).
+    //! \note Call it when no other thread is logging.
+    bool changeLog(project::Info const& info);
+    bool changeLog(std::string const& filename);
+
+private:
+
+    //! \brief Open the file.
+    virtual bool open(std::string const& filename) override;
+
+    //! \brief Close the file and cut its pre-allocated part.
+    virtual void close() override;
+
+    //! \brief Write in the file.
+    inline virtual void write(std::string const& message) override
+    {
+        write(message.c_str(), int(message.size()));
+    }
+
+    //! \brief Write in the file.
+    virtual void write(const char *message, const int length = -1) override;
+
+    //! \brief Write the header of the file.
+    virtual void header() override;
+
+    //! \brief Write the footer of the file.
+    virtual void footer() override;
+
+    //! \brief Copy the line inside the file without lock.
+    virtual void dispatch(std::ostream *stream, enum Severity const severity,
+                          const char *line, size_t const length,
+                          size_t const prefix) override;
+
+    //! \brief Reserve bytes in the file and copy the data into them.
+    void append(const char *data, size_t length);
+
+    //! \brief Return the address of the given segment, mapping it if needed.
+    //! \return nullptr on error: the segment is then marked as failed.
+    char* segment(uint64_t const index);
+
+    //! \brief Account bytes written (or dropped) in the given segment and
+    //! unmap it once it is full.
+    void release(uint64_t const index, size_t const bytes);
+
+private:
+
+    //! \brief A mapped segment of the file.
+    struct Segment
+    {
+        std::atomic<uint64_t> index;
+        std::atomic<char*> address;
+        std::atomic<size_t> written;
+        //! \brief The segment could not be mapped: its lines are dropped but
+        //! still accounted, so that the slot is freed once they are all done.
+        std::atomic<bool> failed;
+    };
+
+    //! \brief Mark the slot as holding the given segment which could not be
+    //! mapped. Called with m_mutex held.
+    //! \return nullptr.
+    char* fail(Segment& slot, uint64_t const index);
+
+    //! \brief Number of segments which can be mapped at the same time.
+    constexpr static size_t c_max_segments = 4u;
+
+    project::Info m_info;
+    int m_fd = -1;
+    size_t m_segment_size;
+    //! \brief Offset in the file of the next line.
+    std::atomic<uint64_t> m_cursor{0u};
+    //! \brief Size of the file pre-allocated so far (guarded by m_mutex).
+    uint64_t m_allocated = 0u;
+    Segment m_segments[c_max_segments];
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_MMAPLOGGER_HPP */
@@ -0,0 +1,171 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_RATELIMIT_HPP
+#  define MYLOGGER_RATELIMIT_HPP
+
+#  include <atomic>
+#  include <cstddef>
+#  include <cstdint>
+#  include <ctime>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Limiter of the LOG_EVERY_N macro: only the first of every n
+//! occurrences of the log statement is logged. One instance per statement.
+// *****************************************************************************
+class EveryN
+{
+public:
+
+    explicit EveryN(uint64_t const n)
+        : m_n((n == 0u) ? 1u : n)
+    {}
+
+    //! \brief Shall this occurrence be logged ?
+    //! \param[out] suppressed always 0: skipped occurrences are expected.
+    bool allow(uint64_t& suppressed)
+    {
+        suppressed = 0u;
+        return (m_count.fetch_add(1u, std::memory_order_relaxed) % m_n) == 0u;
+    }
+
+private:
+
+    std::atomic<uint64_t> m_count{0u};
+    uint64_t const m_n;
+};
+
+// *****************************************************************************
+//! \brief Limiter of the LOG_PER_SECOND macro: at most n occurrences of the
+//! log statement are logged per second. One instance per statement. The
+//! current second and the number of occurrences in this second share a single
+//! atomic word, so the check is one fetch_add (plus a compare-and-swap on the
+//! first occurrence of each second).
+// *****************************************************************************
+class PerSecond
+{
+public:
+
+    explicit PerSecond(uint32_t const n)
+        : m_n(n)
+    {}
+
+    //! \brief Shall this occurrence be logged ?
+    //! \param[out] suppressed the number of occurrences dropped since the
+    //! previous logged one (only set when returning true).
+    bool allow(uint64_t& suppressed)
+    {
+        uint64_t const now = uint64_t(time(nullptr)) & c_count_mask;
+        uint64_t count;
+
+        for (;;)
+        {
+            uint64_t window = m_window.fetch_add(1u, std::memory_order_relaxed);
+            if ((window >> c_count_bits) >= now)
+            {
+                count = window & c_count_mask;
+                break;
+            }
+
+            // First occurrence of a new second: restart the count (only
+            // one thread succeeds, the others count in the new window).
+            ++window;
+            if (m_window.compare_exchange_strong(window, (now << c_count_bits) | 1u,
+                                                 std::memory_order_relaxed))
+            {
+                count = 0u;
+                break;
+            }
+        }
+
+        if (count >= m_n)
+        {
+            m_suppressed.fetch_add(1u, std::memory_order_relaxed);
+            return false;
+        }
+
+        suppressed = (m_suppressed.load(std::memory_order_relaxed) == 0u)
+                     ? 0u : m_suppressed.exchange(0u, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+
+    constexpr static unsigned c_count_bits = 32u;
+    constexpr static uint64_t c_count_mask = (uint64_t(1) << c_count_bits) - 1u;
+
+    //! \brief Second (high bits) and number of occurrences in this second
+    //! (low bits).
+    std::atomic<uint64_t> m_window{0u};
+    std::atomic<uint64_t> m_suppressed{0u};
+    uint64_t const m_n;
+};
+
+// *****************************************************************************
+//! \brief State of the LOG_UNIQUE macro: consecutive identical messages of
+//! the log statement are collapsed into a "last message repeated K times"
+//! line, written before the next different message. One instance per
+//! statement.
+// *****************************************************************************
+class Repeats
+{
+public:
+
+    //! \brief Remember the message of this occurrence.
+    //! \param hash the hash of the message (see hash()).
+    //! \param[out] repeated the number of collapsed occurrences of the
+    //! previous message (only set when returning false).
+    //! \return true if the message is the same than the previous one: the
+    //! occurrence shall not be logged.
+    bool same(uint64_t const hash, uint64_t& repeated)
+    {
+        if (m_last.exchange(hash, std::memory_order_relaxed) == hash)
+        {
+            m_repeated.fetch_add(1u, std::memory_order_relaxed);
+            return true;
+        }
+
+        repeated = (m_repeated.load(std::memory_order_relaxed) == 0u)
+                   ? 0u : m_repeated.exchange(0u, std::memory_order_relaxed);
+        return false;
+    }
+
+    //! \brief FNV-1a hash of a message.
+    static uint64_t hash(const char* data, size_t const length)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0u; i < length; ++i)
+        {
+            h = (h ^ uint8_t(data[i])) * 1099511628211ull;
+        }
+        return h;
+    }
+
+private:
+
+    std::atomic<uint64_t> m_last{0u};
+    std::atomic<uint64_t> m_repeated{0u};
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_RATELIMIT_HPP */
@@ -0,0 +1,215 @@
+// -*- c++ -*- Coloration Syntaxique pour Emacs
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_RINGBUFFER_TPP
+#  define MYLOGGER_RINGBUFFER_TPP
+
+#  include <atomic>
+#  include <memory>
+#  include <cstddef>
+#  include <cstdint>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Bounded lock-free queue allowing several producers and consumers.
+//!
+//! Each cell holds a sequence number telling producers and consumers whether
+//! the cell is free or filled (Dmitry Vyukov's bounded MPMC queue). Producers
+//! and consumers only compete on a single atomic counter each, and elements
+//! are built and read in place through a functor so that large records are
+//! never copied twice.
+//!
+//! \note The capacity is rounded up to the next power of two.
+// *****************************************************************************
+template <class T>
+class RingBuffer
+{
+public:
+
+    //--------------------------------------------------------------------------
+    //! \brief Allocate the cells of the queue.
+    //! \param capacity the maximum number of elements (rounded up to a power
+    //! of two, minimum 2).
+    //--------------------------------------------------------------------------
+    explicit RingBuffer(size_t const capacity)
+        : m_capacity(roundUp(capacity)),
+          m_mask(m_capacity - 1u),
+          m_cells(new Cell[m_capacity]),
+          m_enqueue_pos(0u),
+          m_dequeue_pos(0u)
+    {
+        for (size_t i = 0u; i < m_capacity; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Reserve a cell, let the functor fill it, then publish it.
+    //! \param fill functor with the signature void(T&).
+    //! \return false if the queue is full (nothing has been inserted).
+    //--------------------------------------------------------------------------
+    template <class Fn>
+    bool push(Fn&& fill)
+    {
+        Cell* cell;
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos);
+            if (diff == 0)
+            {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        fill(cell->data);
+        cell->sequence.store(pos + 1u, std::memory_order_release);
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Take the oldest cell, let the functor read it, then release it.
+    //! \param consume functor with the signature void(T&).
+    //! \return false if the queue is empty.
+    //--------------------------------------------------------------------------
+    template <class Fn>
+    bool pop(Fn&& consume)
+    {
+        Cell* cell;
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(seq) - intptr_t(pos + 1u);
+            if (diff == 0)
+            {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        consume(cell->data);
+        cell->sequence.store(pos + m_mask + 1u, std::memory_order_release);
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Approximate emptiness (exact when producers are quiet).
+    //--------------------------------------------------------------------------
+    bool empty() const
+    {
+        return m_enqueue_pos.load(std::memory_order_acquire) ==
+               m_dequeue_pos.load(std::memory_order_acquire);
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Would push() fail now ? Approximate like size() but, unlike it,
+    //! also counts the cells still read by pop().
+    //--------------------------------------------------------------------------
+    bool full() const
+    {
+        size_t const pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        size_t const seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+        return intptr_t(seq) - intptr_t(pos) < 0;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Approximate number of queued elements (exact when producers
+    //! and consumers are quiet).
+    //--------------------------------------------------------------------------
+    size_t size() const
+    {
+        size_t const dequeued = m_dequeue_pos.load(std::memory_order_acquire);
+        size_t const enqueued = m_enqueue_pos.load(std::memory_order_acquire);
+        return (enqueued > dequeued) ? enqueued - dequeued : 0u;
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of cells.
+    //--------------------------------------------------------------------------
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+
+    //! \brief Forbid usage of constructor by copy.
+    RingBuffer(RingBuffer const&) = delete;
+    //! \brief Forbid usage of the copy assignement.
+    RingBuffer& operator=(RingBuffer const&) = delete;
+
+    //! \brief Round up to the next power of two.
+    static size_t roundUp(size_t n)
+    {
+        size_t p = 2u;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+private:
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    size_t const m_capacity;
+    size_t const m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    //! \brief Producers and consumers live on different cache lines (padding
+    //! is used instead of alignas which needs C++17 aligned new).
+    char m_pad0[64];
+    std::atomic<size_t> m_enqueue_pos;
+    char m_pad1[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_dequeue_pos;
+    char m_pad2[64 - sizeof(std::atomic<size_t>)];
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_RINGBUFFER_TPP */
@@ -0,0 +1,79 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_SEQUENCE_HPP
+#  define MYLOGGER_SEQUENCE_HPP
+
+#  include "MyLogger/Clock.hpp"
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Stamp starting a log line when sequencing is enabled: the full time
+//! of the line, the thread having logged it and its rank among the lines of
+//! this thread. Written as "{time thread:sequence}", the time being in
+//! nanoseconds since the Epoch.
+// *****************************************************************************
+struct Stamp
+{
+    uint64_t time;
+    uint32_t thread;
+    uint64_t sequence;
+};
+
+// *****************************************************************************
+//! \brief Per-thread sequence numbers of log lines. Once lines are written
+//! by several threads, by the writer thread of the asynchronous mode or by
+//! several processes, the order of the lines in the files no longer strictly
+//! follows the order of the events: the stamps let the mylogger-merge tool
+//! restore it.
+//!
+//! \note Lines formatted by the writer thread (MYLOGGER_DEFERRED_FORMATTING)
+//! and binary files have no stamp.
+// *****************************************************************************
+class Sequence
+{
+public:
+
+    //! \brief Start (or stop) stamping log lines. Disabled by default.
+    static void enable(bool const enable);
+
+    //! \brief Are log lines stamped ?
+    static bool enabled();
+
+    //! \brief Write the stamp of a new line of the calling thread, when
+    //! enabled, and increment the sequence number of the thread.
+    //! \return the number of chars written (0 when disabled or when the
+    //! buffer is too small).
+    static size_t stamp(char* buffer, size_t const size, Timestamp const& when);
+
+    //! \brief Read the stamp starting a log line.
+    //! \return the length of the stamp, 0 if the line does not start by a
+    //! stamp.
+    static size_t parse(const char* line, size_t const length, Stamp& stamp);
+
+    //! \brief Return the identifier of the calling thread (its kernel
+    //! identifier when available).
+    static uint32_t thread();
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_SEQUENCE_HPP */
@@ -0,0 +1,49 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#ifndef MYLOGGER_SEVERITY_HPP
+#  define MYLOGGER_SEVERITY_HPP
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Different severity enumerate
+// *****************************************************************************
+enum Severity
+{
+    None, Info, Debug, Warning, Failed, Error, Signal, Exception,
+    Catch, Fatal, MaxLoggerSeverity = Fatal
+};
+
+//------------------------------------------------------------------------------
+//! \brief Order of the severities for the thresholds: Debug is below Info,
+//! unlike their values in enum Severity which are kept for the tables and the
+//! binary log files. The mapping is its own inverse: rank(Severity(rank(s)))
+//! is s.
+//------------------------------------------------------------------------------
+constexpr int rank(enum Severity const severity)
+{
+    return (severity == Info) ? int(Debug) : ((severity == Debug) ? int(Info) : int(severity));
+}
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_SEVERITY_HPP */
@@ -22,6 +22,9 @@
 #ifndef MYLOGGER_SINGLETON_TPP
 #  define MYLOGGER_SINGLETON_TPP
 
+#  include <atomic>
+#  include <mutex>
+
 namespace mylogger {
 
 // *****************************************************************************
@@ -73,6 +76,53 @@ private:
     LongLifeSingleton& operator=(LongLifeSingleton &&) = delete;
 };
 
+// *****************************************************************************
+//! \brief Same than LongLifeSingleton but each thread caches the address of
+//! the instance in a thread-local pointer: after the first call, instance()
+//! no longer checks the guard of the function-local static.
+//!
+//! \note Like LongLifeSingleton, the instance cannot be destroyed before the
+//! end of the program, so the cached addresses never dangle.
+// *****************************************************************************
+template <class T>
+class ThreadCachedSingleton
+{
+public:
+
+    static T& instance()
+    {
+        static thread_local T* t_instance = nullptr;
+        if (nullptr == t_instance)
+        {
+            t_instance = &create();
+        }
+        return *t_instance;
+    }
+
+protected:
+
+    ThreadCachedSingleton() = default;
+    ~ThreadCachedSingleton() = default;
+
+private:
+
+    //! \brief Thread-safe creation (function-local static).
+    static T& create()
+    {
+        static T instance;
+        return instance;
+    }
+
+    //! \brief Forbid usage of constructor by copy.
+    ThreadCachedSingleton(ThreadCachedSingleton const&) = delete;
+    //! \brief Forbid usage of constructor by moving.
+    ThreadCachedSingleton(ThreadCachedSingleton&&) = delete;
+    //! \brief Forbid usage of the copy assignement.
+    ThreadCachedSingleton& operator=(ThreadCachedSingleton const&) = delete;
+    //! \brief Forbid usage of the move assignement.
+    ThreadCachedSingleton& operator=(ThreadCachedSingleton &&) = delete;
+};
+
 // *****************************************************************************
 //! \brief
 // *****************************************************************************
@@ -115,8 +165,9 @@ private:
 //! \brief The regular singleton (use pointer for returning the instance).
 //!
 //! You have to manage by yourself its life (when to instanciated and
-//! when to to released it). This class is not thread safe when it's
-//! instancing.
+//! when to to released it). The first calls to instance() may race (see
+//! LazySingleton) but destroy() shall not be called while other threads use
+//! the instance.
 //!
 //! \note: Beware when using several singletons depending each others:
 //! the order of destructor calls is undefined. Therefore this can
@@ -131,20 +182,26 @@ public:
 
     static T& instance()
     {
-        if (nullptr == s_instance)
+        T* instance = s_instance.load(std::memory_order_acquire);
+        if (nullptr == instance)
         {
-            s_instance = new T;
+            std::lock_guard<std::mutex> lock(s_mutex);
+            instance = s_instance.load(std::memory_order_relaxed);
+            if (nullptr == instance)
+            {
+                instance = new T;
+                s_instance.store(instance, std::memory_order_release);
+            }
         }
-        return *s_instance;
+        return *instance;
     }
 
     static void destroy()
     {
-        if (nullptr != s_instance)
-        {
-            delete s_instance;
-            s_instance = nullptr;
-        }
+        // The instance is still reachable by its destructor.
+        std::lock_guard<std::mutex> lock(s_mutex);
+        delete s_instance.load(std::memory_order_relaxed);
+        s_instance.store(nullptr, std::memory_order_release);
     }
 
 protected:
@@ -154,13 +211,16 @@ protected:
 
 private:
 
-    static T* s_instance;
+    static std::atomic<T*> s_instance;
+    //! \brief Serialize the creation and the destruction.
+    static std::mutex s_mutex;
 
     Singleton(Singleton&);
     void operator=(Singleton);
 };
 
-template <class T> T* Singleton<T>::s_instance = nullptr;
+template <class T> std::atomic<T*> Singleton<T>::s_instance{nullptr};
+template <class T> std::mutex Singleton<T>::s_mutex;
 
 // *****************************************************************************
 //! \brief Lazy singleton (use pointer for returning the instance).
@@ -185,47 +245,27 @@ private:
 
 public:
 
+    //! \brief Return the instance, created by the first call. Double-checked
+    //! locking (see http://www.aristeia.com/Papers/DDJ_Jul_Aug_2004_revised.pdf):
+    //! once created, the cost is a single acquire load.
     static T& instance()
     {
-        //! See http://www.aristeia.com/Papers/DDJ_Jul_Aug_2004_revised.pdf
-        if (nullptr == s_instance)
-        {
-            //FIXME add lock for thread safe
-            // if (nullptr == s_instance)
-            {
-                T* volatile temp = new T;
-                s_instance = temp;
-                s_destroyer.set(*s_instance);
-            }
-        }
-        return *s_instance;
+        return create([]() { return new T; });
     }
 
     //\! brief Create the constructor and pass infinite number of args
     template<class Fn, class ... Args>
     static T& instance(Fn&& fn, Args&&... args)
     {
-        //! See http://www.aristeia.com/Papers/DDJ_Jul_Aug_2004_revised.pdf
-        if (nullptr == s_instance)
-        {
-            //FIXME add lock for thread safe
-            // if (nullptr == s_instance)
-            {
-                T* volatile temp = new T(fn, args...);
-                s_instance = temp;
-                s_destroyer.set(*s_instance);
-            }
-        }
-        return *s_instance;
+        return create([&]() { return new T(fn, args...); });
     }
 
     static void destroy()
     {
-        if (nullptr != s_instance)
-        {
-            delete s_instance;
-            s_instance = nullptr;
-        }
+        // The instance is still reachable by its destructor.
+        std::lock_guard<std::mutex> lock(s_mutex);
+        delete s_instance.load(std::memory_order_relaxed);
+        s_instance.store(nullptr, std::memory_order_release);
     }
 
 protected:
@@ -243,15 +283,40 @@ private:
     LazySingleton& operator=(LazySingleton const&) = delete;
     //! \brief Forbid usage of the move assignement.
     LazySingleton& operator=(LazySingleton &&) = delete;
+
+    //! \brief Create the instance with the given functor if it does not
+    //! exist yet. The mutex is only taken while there is no instance.
+    template<class Fn>
+    static T& create(Fn&& fn)
+    {
+        T* instance = s_instance.load(std::memory_order_acquire);
+        if (nullptr == instance)
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            instance = s_instance.load(std::memory_order_relaxed);
+            if (nullptr == instance)
+            {
+                instance = fn();
+                s_destroyer.set(*instance);
+                s_instance.store(instance, std::memory_order_release);
+            }
+        }
+        return *instance;
+    }
+
     //! \brief The instance of the singleton (init to nullptr).
     static SingletonDestroyer<T> s_destroyer;
-    static T* volatile s_instance;
+    static std::atomic<T*> s_instance;
+    //! \brief Serialize the creation and the destruction.
+    static std::mutex s_mutex;
 };
 
 template <class T>
-T* volatile LazySingleton<T>::s_instance = nullptr;
+std::atomic<T*> LazySingleton<T>::s_instance{nullptr};
 template <class T>
 SingletonDestroyer<T> LazySingleton<T>::s_destroyer;
+template <class T>
+std::mutex LazySingleton<T>::s_mutex;
 
 } // namespace mylogger
 
@@ -0,0 +1,198 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_SINK_HPP
+#  define MYLOGGER_SINK_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include "MyLogger/RingBuffer.tpp"
+#  include <atomic>
+#  include <condition_variable>
+#  include <functional>
+#  include <memory>
+#  include <thread>
+#  include <vector>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief A formatted log line given to the sinks. All sinks share the same
+//! buffer: it is only valid during the call to ISink::consume().
+// *****************************************************************************
+struct LogEntry
+{
+    enum Severity severity;
+    //! \brief The whole line: time, severity, location, message and '\n'.
+    const char* line;
+    size_t length;
+    //! \brief Length of the time, severity and location before the message.
+    size_t prefix;
+
+    //! \brief The message without the prefix.
+    const char* message() const
+    {
+        return line + prefix;
+    }
+
+    //! \brief Length of the message without the prefix.
+    size_t messageLength() const
+    {
+        return length - prefix;
+    }
+};
+
+//! \brief Reformat a line for a sink: write the text inside the given buffer
+//! of the given size and return its length.
+typedef std::function<size_t(LogEntry const& entry, char* buffer, size_t const size)> Formatter;
+
+// *****************************************************************************
+//! \brief Interface class for the outputs of the logger. Each sink has its own
+//! severity threshold and, optionally, its own formatter. Without formatter
+//! the line formatted by the logger is written as it is, without copy.
+//!
+//! \note The logger serializes the calls to consume() and idle().
+// *****************************************************************************
+class ISink
+{
+public:
+
+    virtual ~ISink() = default;
+
+    //! \brief Lines of lower severity are ignored by this sink.
+    void threshold(enum Severity const severity)
+    {
+        m_threshold.store(int(severity), std::memory_order_relaxed);
+    }
+
+    //! \brief Return the severity threshold of this sink.
+    enum Severity threshold() const
+    {
+        return Severity(m_threshold.load(std::memory_order_relaxed));
+    }
+
+    //! \brief Change the formatter of this sink (nullptr for the line of the
+    //! logger). Call it before adding the sink to the logger.
+    void formatter(Formatter const& formatter)
+    {
+        m_formatter = formatter;
+    }
+
+    //! \brief Filter, format and write a line.
+    virtual void consume(LogEntry const& entry);
+
+    //! \brief Called regularly by the writer thread of the asynchronous mode
+    //! when there is nothing to log (for example to flush buffers).
+    virtual void idle() {}
+
+protected:
+
+    //! \brief Does the sink accept lines of this severity ?
+    bool accepts(enum Severity const severity) const
+    {
+        return rank(severity) >= rank(Severity(m_threshold.load(std::memory_order_relaxed)));
+    }
+
+    //! \brief Return the text to write for the entry: its line, or the
+    //! output of the formatter (valid until the next call).
+    //! \param[out] length the length of the text.
+    const char* format(LogEntry const& entry, size_t& length);
+
+private:
+
+    //! \brief Write the formatted text of the entry in the media.
+    virtual void write(LogEntry const& entry, const char* text, size_t const length) = 0;
+
+private:
+
+    std::atomic<int> m_threshold{int(None)};
+    Formatter m_formatter;
+    //! \brief Output of the formatter.
+    std::vector<char> m_buffer;
+};
+
+// *****************************************************************************
+//! \brief Run a slow sink on its own thread so it cannot stall the logger nor
+//! the other sinks. Lines are copied into a bounded lock-free queue; when the
+//! queue is full, lines are dropped and counted. The formatter of the
+//! AsyncSink, if any, is applied before queueing: the wrapped sink then gets
+//! its output as the whole line (and message), and applies its own formatter.
+// *****************************************************************************
+class AsyncSink: public ISink
+{
+public:
+
+    //! \brief Maximum length of the lines stored inside the queue. Longer
+    //! lines are copied into a chunk of the ChunkPool.
+    constexpr static size_t c_max_line = 1024u;
+
+    //! \param sink the slow sink.
+    //! \param capacity the maximum number of queued lines.
+    AsyncSink(std::shared_ptr<ISink> const& sink, size_t const capacity = 1024u);
+
+    //! \brief Write the queued lines then stop the thread.
+    virtual ~AsyncSink();
+
+    //! \brief Queue the line for the thread.
+    virtual void consume(LogEntry const& entry) override;
+
+    //! \brief Wait until the queued lines have been written.
+    void drain();
+
+    //! \brief Return the number of lines lost because of a full queue.
+    uint64_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    virtual void write(LogEntry const&, const char*, size_t const) override {}
+
+    //! \brief Body of the thread.
+    void run();
+
+private:
+
+    //! \brief A line waiting in the queue.
+    struct Record
+    {
+        uint8_t severity;
+        uint16_t prefix;
+        uint32_t length;
+        char data[c_max_line];
+        //! \brief Chunk holding a long line (nullptr if unused).
+        char* chunk;
+        size_t capacity;
+    };
+
+    std::shared_ptr<ISink> m_sink;
+    RingBuffer<Record> m_queue;
+    std::atomic<uint64_t> m_dropped{0u};
+    std::atomic<bool> m_running{true};
+    std::atomic<bool> m_busy{false};
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_drained;
+    std::thread m_thread;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_SINK_HPP */
@@ -0,0 +1,179 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_SINKS_HPP
+#  define MYLOGGER_SINKS_HPP
+
+#  include "MyLogger/Sink.hpp"
+#  include "MyLogger/BufferedFile.hpp"
+#  include "MyLogger/Archiver.hpp"
+#  include "MyLogger/Console.hpp"
+#  include <string>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Sink writing lines into a file through a BufferedFile.
+// *****************************************************************************
+class FileSink: public ISink
+{
+public:
+
+    //! \brief Create or truncate the file.
+    FileSink(std::string const& path, FlushPolicy const& policy = FlushPolicy());
+
+    //! \brief Is the file opened ?
+    bool isOpen() const
+    {
+        return m_file.isOpen();
+    }
+
+    //! \brief Flush the buffer if its oldest line is too old.
+    virtual void idle() override;
+
+protected:
+
+    virtual void write(LogEntry const& entry, const char* text, size_t const length) override;
+
+protected:
+
+    std::string m_path;
+    BufferedFile m_file;
+};
+
+// *****************************************************************************
+//! \brief File sink rotated by size or time (see RotationPolicy). Old files
+//! are archived by a background thread.
+// *****************************************************************************
+class RotatingFileSink: public FileSink
+{
+public:
+
+    RotatingFileSink(std::string const& path, RotationPolicy const& rotation,
+                     FlushPolicy const& policy = FlushPolicy());
+
+private:
+
+    virtual void write(LogEntry const& entry, const char* text, size_t const length) override;
+
+private:
+
+    Archiver m_archiver;
+};
+
+// *****************************************************************************
+//! \brief Sink writing each line on the standard output or error with a
+//! single system call (no std::ostream and no flush), colored depending on
+//! its severity (see Console).
+// *****************************************************************************
+class ConsoleSink: public ISink
+{
+public:
+
+    //! \param fd 1 for the standard output, 2 for the standard error.
+    //! \param mode when lines are colored.
+    explicit ConsoleSink(int const fd = 1, ColorMode const mode = ColorMode::Auto)
+        : m_console(fd, mode)
+    {}
+
+private:
+
+    virtual void write(LogEntry const& entry, const char* text, size_t const length) override;
+
+private:
+
+    Console m_console;
+};
+
+// *****************************************************************************
+//! \brief Sink keeping the most recent lines in memory, for example to dump
+//! them when a problem occurs.
+// *****************************************************************************
+class MemorySink: public ISink
+{
+public:
+
+    //! \param capacity the number of bytes kept.
+    explicit MemorySink(size_t const capacity = 64u * 1024u);
+
+    //! \brief Return the complete lines kept, from the oldest one.
+    std::string content() const;
+
+private:
+
+    virtual void write(LogEntry const& entry, const char* text, size_t const length) override;
+
+private:
+
+    mutable std::mutex m_mutex;
+    std::vector<char> m_ring;
+    //! \brief Total number of bytes written.
+    uint64_t m_written = 0u;
+};
+
+#  if !defined(_WIN32)
+
+// *****************************************************************************
+//! \brief Sink sending lines to the local syslog daemon through its Unix
+//! datagram socket (RFC 3164 format: "<priority>tag: message"). The default
+//! formatter only keeps the message since syslog adds its own time.
+//!
+//! \note Not available on Windows.
+// *****************************************************************************
+class SyslogSink: public ISink
+{
+public:
+
+    //! \brief Facility "user-level messages".
+    constexpr static int c_user = 1;
+
+    //! \param tag the name of the application.
+    //! \param facility the syslog facility.
+    //! \param path the socket of the syslog daemon.
+    SyslogSink(std::string const& tag, int const facility = c_user,
+               std::string const& path = "/dev/log");
+
+    virtual ~SyslogSink();
+
+    //! \brief Is the socket connected ?
+    bool isOpen() const
+    {
+        return m_socket >= 0;
+    }
+
+    //! \brief Return the syslog level of a severity.
+    static int level(enum Severity const severity);
+
+private:
+
+    virtual void write(LogEntry const& entry, const char* text, size_t const length) override;
+
+private:
+
+    std::string m_tag;
+    int m_facility;
+    int m_socket = -1;
+};
+
+#  endif // !_WIN32
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_SINKS_HPP */
@@ -0,0 +1,97 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_SITE_HPP
+#  define MYLOGGER_SITE_HPP
+
+#  include "MyLogger/ILogger.hpp"
+#  include <atomic>
+#  include <cstdint>
+#  include <string>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief Static information of a log statement in the source code. Created
+//! once by the LOG* macros, then referenced by its identifier.
+// *****************************************************************************
+struct Site
+{
+    //! \brief Severity of the log statement.
+    enum Severity severity;
+    //! \brief Base name of the source file (nullptr for LOGB).
+    const char* file;
+    //! \brief Line in the source file.
+    int line;
+    //! \brief The printf format given by the user.
+    const char* format;
+    //! \brief Precomputed "[file::line] " (empty when no file).
+    std::string location;
+};
+
+// *****************************************************************************
+//! \brief Table of all log statements met so far. Registration (once per site)
+//! takes a lock but lookups are lock-free: sites are stored in chunks which
+//! never move nor are freed.
+// *****************************************************************************
+class Sites
+{
+public:
+
+    //! \brief Maximum number of log statements.
+    constexpr static uint32_t c_max_sites = 256u * 256u;
+
+    //--------------------------------------------------------------------------
+    //! \brief Register a new log statement.
+    //! \return its identifier.
+    //--------------------------------------------------------------------------
+    static uint32_t add(enum Severity const severity, const char* file,
+                        int const line, const char* format);
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the log statement of the given identifier.
+    //! \note the identifier shall have been returned by add().
+    //--------------------------------------------------------------------------
+    static Site const& get(uint32_t const id)
+    {
+        return s_chunks[id >> c_chunk_bits].load(std::memory_order_acquire)
+                       [id & (c_chunk_size - 1u)];
+    }
+
+    //--------------------------------------------------------------------------
+    //! \brief Return the number of registered log statements.
+    //--------------------------------------------------------------------------
+    static uint32_t size()
+    {
+        return s_size.load(std::memory_order_acquire);
+    }
+
+private:
+
+    constexpr static uint32_t c_chunk_bits = 8u;
+    constexpr static uint32_t c_chunk_size = 1u << c_chunk_bits;
+
+    static std::atomic<Site*> s_chunks[c_max_sites / c_chunk_size];
+    static std::atomic<uint32_t> s_size;
+};
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_SITE_HPP */
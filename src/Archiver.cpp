@@ -0,0 +1,212 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Archiver.hpp"
+#include <cstdio>
+#include <fstream>
+#include <zlib.h>
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+//! \brief Does the file exist ?
+//------------------------------------------------------------------------------
+static bool exists(std::string const& path)
+{
+    return std::ifstream(path).good();
+}
+
+//------------------------------------------------------------------------------
+Archiver::~Archiver()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeup.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+void Archiver::policy(RotationPolicy const& policy)
+{
+    m_policy = policy;
+    m_next = 0;
+    if (m_policy.interval.count() > 0)
+    {
+        time_t const interval = time_t(m_policy.interval.count());
+        m_next = (time(nullptr) / interval + 1) * interval;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool Archiver::due(uint64_t const size)
+{
+    if ((m_policy.bytes != 0u) && (size >= m_policy.bytes))
+    {
+        policy(m_policy);
+        return true;
+    }
+    if ((m_next != 0) && (time(nullptr) >= m_next))
+    {
+        policy(m_policy);
+        return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+std::string Archiver::incoming(std::string const& path)
+{
+    return path + ".incoming." + std::to_string(++m_sequence);
+}
+
+//------------------------------------------------------------------------------
+std::string Archiver::generation(std::string const& path, size_t const index)
+{
+    std::string::size_type const slash = path.find_last_of("/\\");
+    std::string::size_type const dot = path.find_last_of('.');
+    std::string const suffix = "." + std::to_string(index);
+
+    if ((dot == std::string::npos) || ((slash != std::string::npos) && (dot < slash)))
+        return path + suffix;
+    return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+//------------------------------------------------------------------------------
+void Archiver::archive(std::string const& path, std::string const& incoming)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(Job{path, incoming, m_policy});
+        if (!m_thread.joinable())
+        {
+            m_thread = std::thread(&Archiver::run, this);
+        }
+    }
+    m_wakeup.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void Archiver::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_jobs.empty() && !m_busy; });
+}
+
+//------------------------------------------------------------------------------
+void Archiver::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+        m_wakeup.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty())
+            return ;
+
+        Job job = std::move(m_jobs.front());
+        m_jobs.pop_front();
+        m_busy = true;
+        lock.unlock();
+        process(job.path, job.incoming, job.policy);
+        lock.lock();
+        m_busy = false;
+        m_done.notify_all();
+    }
+}
+
+//------------------------------------------------------------------------------
+void Archiver::process(std::string const& path, std::string const& incoming,
+                       RotationPolicy const& policy)
+{
+    // Jobs are processed in order: the closed file is at the log path. Move
+    // it aside then give the log path to the file in use. If the closed file
+    // cannot be moved, the new one keeps its incoming name.
+    std::string const pending = path + ".rotated";
+    if (std::rename(path.c_str(), pending.c_str()) != 0)
+        return ;
+    std::rename(incoming.c_str(), path.c_str());
+
+    if (policy.generations == 0u)
+    {
+        std::remove(pending.c_str());
+        return ;
+    }
+
+    // Drop the oldest generation then shift the others: name.1 -> name.2 ...
+    std::string const gz = ".gz";
+    std::remove(generation(path, policy.generations).c_str());
+    std::remove((generation(path, policy.generations) + gz).c_str());
+    for (size_t i = policy.generations - 1u; i >= 1u; --i)
+    {
+        std::string const from = generation(path, i);
+        std::string const to = generation(path, i + 1u);
+        if (exists(from))
+            std::rename(from.c_str(), to.c_str());
+        if (exists(from + gz))
+            std::rename((from + gz).c_str(), (to + gz).c_str());
+    }
+
+    std::string const first = generation(path, 1u);
+    if (policy.compress && compress(pending, first + gz))
+    {
+        std::remove(pending.c_str());
+    }
+    else
+    {
+        std::rename(pending.c_str(), first.c_str());
+    }
+}
+
+//------------------------------------------------------------------------------
+bool Archiver::compress(std::string const& source, std::string const& destination)
+{
+    std::ifstream input(source, std::ios::binary);
+    if (!input)
+        return false;
+
+    gzFile output = gzopen(destination.c_str(), "wb");
+    if (output == nullptr)
+        return false;
+
+    char buffer[64u * 1024u];
+    bool ok = true;
+    while (ok && input)
+    {
+        input.read(buffer, sizeof (buffer));
+        std::streamsize const n = input.gcount();
+        if (n > 0)
+        {
+            ok = (gzwrite(output, buffer, unsigned(n)) == int(n));
+        }
+    }
+    ok = (gzclose(output) == Z_OK) && ok;
+    if (!ok)
+    {
+        std::remove(destination.c_str());
+    }
+    return ok;
+}
+
+} // namespace mylogger
@@ -0,0 +1,291 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/BinaryLog.hpp"
+#include "MyLogger/Deferred.hpp"
+#include "MyLogger/Site.hpp"
+#include <cstring>
+
+namespace mylogger {
+namespace binary {
+
+//! \brief Maximum number of bytes of a varint.
+static constexpr size_t c_max_varint = 10u;
+
+//------------------------------------------------------------------------------
+//! \brief Store an unsigned integer 7 bits per byte, lowest bits first.
+//! \return the number of bytes written.
+//------------------------------------------------------------------------------
+static size_t varint(char* buffer, uint64_t value)
+{
+    size_t n = 0u;
+    while (value >= 0x80u)
+    {
+        buffer[n++] = char(uint8_t(value) | 0x80u);
+        value >>= 7;
+    }
+    buffer[n++] = char(value);
+    return n;
+}
+
+//------------------------------------------------------------------------------
+void Writer::start(BufferedFile& file)
+{
+    m_defined = 0u;
+    m_time = 0u;
+    file.write(c_magic, sizeof (c_magic), None);
+    define(file, Sites::size());
+}
+
+//------------------------------------------------------------------------------
+void Writer::define(BufferedFile& file, uint32_t const until)
+{
+    char buffer[4u * c_max_varint];
+
+    for (; m_defined < until; ++m_defined)
+    {
+        mylogger::Site const& site = Sites::get(m_defined);
+        const char* name = (site.file == nullptr) ? "" : site.file;
+        size_t const name_length = strlen(name);
+        size_t const format_length = strlen(site.format);
+
+        size_t n = 0u;
+        buffer[n++] = char(Tag::Definition);
+        n += varint(buffer + n, m_defined);
+        buffer[n++] = char(site.severity);
+        n += varint(buffer + n, uint64_t(site.line));
+        n += varint(buffer + n, name_length);
+        file.write(buffer, n, None);
+        file.write(name, name_length, None);
+        n = varint(buffer, format_length);
+        file.write(buffer, n, None);
+        file.write(site.format, format_length, None);
+    }
+}
+
+//------------------------------------------------------------------------------
+uint64_t Writer::delta(uint64_t const time)
+{
+    int64_t const elapsed = int64_t(time - m_time);
+    m_time = time;
+    return (uint64_t(elapsed) << 1) ^ uint64_t(elapsed >> 63);
+}
+
+//------------------------------------------------------------------------------
+void Writer::statement(BufferedFile& file, const char* record, size_t const length)
+{
+    if (length < sizeof (deferred::Header))
+        return ;
+
+    deferred::Header const header = deferred::header(record);
+    if (header.site >= m_defined)
+    {
+        define(file, header.site + 1u);
+    }
+
+    char buffer[3u * c_max_varint + 1u];
+    size_t const args = length - sizeof (deferred::Header);
+    size_t n = 0u;
+    buffer[n++] = char(Tag::Statement);
+    n += varint(buffer + n, header.site);
+    n += varint(buffer + n, delta(Clock::nanoseconds(header.time)));
+    n += varint(buffer + n, args);
+    file.write(buffer, n, None);
+    file.write(record + sizeof (deferred::Header), args, Sites::get(header.site).severity);
+}
+
+//------------------------------------------------------------------------------
+void Writer::text(BufferedFile& file, const char* text, size_t const length,
+                  enum Severity const severity)
+{
+    char buffer[2u * c_max_varint + 2u];
+    size_t n = 0u;
+    buffer[n++] = char(Tag::Text);
+    buffer[n++] = char(severity);
+    n += varint(buffer + n, delta(Clock::nanoseconds(Clock::now())));
+    n += varint(buffer + n, length);
+    file.write(buffer, n, None);
+    file.write(text, length, severity);
+}
+
+//------------------------------------------------------------------------------
+Reader::Reader(const char* data, size_t const size, Filter const& filter)
+    : m_cursor(data), m_end(data + size), m_filter(filter)
+{
+    m_valid = (size >= sizeof (c_magic)) &&
+              (memcmp(data, c_magic, sizeof (c_magic)) == 0);
+    m_cursor += m_valid ? sizeof (c_magic) : size;
+}
+
+//------------------------------------------------------------------------------
+bool Reader::byte(uint8_t& value)
+{
+    if (m_cursor >= m_end)
+        return false;
+    value = uint8_t(*m_cursor++);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool Reader::varint(uint64_t& value)
+{
+    value = 0u;
+    for (unsigned shift = 0u; (m_cursor < m_end) && (shift < 64u); shift += 7u)
+    {
+        uint8_t const b = uint8_t(*m_cursor++);
+        value |= uint64_t(b & 0x7fu) << shift;
+        if ((b & 0x80u) == 0u)
+            return true;
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool Reader::bytes(const char*& data, size_t& length)
+{
+    uint64_t n;
+    if (!varint(n) || (n > uint64_t(m_end - m_cursor)))
+        return false;
+    data = m_cursor;
+    length = size_t(n);
+    m_cursor += length;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool Reader::time(uint64_t& time)
+{
+    uint64_t zigzag;
+    if (!varint(zigzag))
+        return false;
+    m_time += uint64_t(int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1u));
+    time = m_time;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool Reader::define()
+{
+    uint64_t id, line;
+    uint8_t severity;
+    const char *file, *format;
+    size_t file_length, format_length;
+
+    if (!varint(id) || !byte(severity) || !varint(line) ||
+        !bytes(file, file_length) || !bytes(format, format_length) ||
+        (id > m_sites.size()) || (severity > MaxLoggerSeverity))
+        return false;
+
+    if (id == m_sites.size())
+    {
+        m_sites.push_back(Site());
+    }
+    Site& site = m_sites[size_t(id)];
+    site.severity = Severity(severity);
+    site.file.assign(file, file_length);
+    site.format.assign(format, format_length);
+    site.location.clear();
+    if (file_length != 0u)
+    {
+        site.location = "[" + site.file + "::" + std::to_string(line) + "] ";
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool Reader::kept(enum Severity const severity, uint64_t const time) const
+{
+    return (rank(severity) >= rank(m_filter.severity)) &&
+           (time >= m_filter.from) && (time <= m_filter.to);
+}
+
+//------------------------------------------------------------------------------
+bool Reader::next(std::string& line)
+{
+    char buffer[4096];
+    uint8_t tag;
+    uint64_t when;
+
+    while (byte(tag))
+    {
+        switch (tag)
+        {
+        case Tag::Definition:
+            if (!define())
+                return false;
+            break;
+
+        case Tag::Text:
+        {
+            uint8_t severity;
+            const char* text;
+            size_t length;
+            if (!byte(severity) || !time(when) || !bytes(text, length))
+                return false;
+            if (m_filter.file.empty() && kept(Severity(severity), when))
+            {
+                line.assign(text, length);
+                return true;
+            }
+            break;
+        }
+
+        case Tag::Statement:
+        {
+            uint64_t id;
+            const char* args;
+            size_t length;
+            if (!varint(id) || !time(when) || !bytes(args, length) ||
+                (id >= m_sites.size()))
+                return false;
+
+            Site const& site = m_sites[size_t(id)];
+            if (!kept(site.severity, when) ||
+                (!m_filter.file.empty() && (site.file != m_filter.file)))
+                break;
+
+            // Rebuild the encoded log statement expected by the formatter.
+            deferred::Header const header = { uint32_t(id), { when, false } };
+            m_record.assign(reinterpret_cast<const char*>(&header), sizeof (header));
+            m_record.append(args, length);
+
+            size_t const n = Clock::format(buffer, sizeof (buffer), header.time);
+            line.assign(buffer, n);
+            line += ILogger::severityName(site.severity);
+            line += site.location;
+            line.append(buffer, deferred::format(buffer, sizeof (buffer), site.format.c_str(),
+                                                 m_record.data(), m_record.size()));
+            if (line.empty() || (line.back() != '\n'))
+            {
+                line += '\n';
+            }
+            return true;
+        }
+
+        default:
+            return false;
+        }
+    }
+
+    return false;
+}
+
+} // namespace binary
+} // namespace mylogger
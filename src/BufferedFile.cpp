@@ -0,0 +1,147 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/BufferedFile.hpp"
+#include "MyLogger/Metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+BufferedFile::BufferedFile()
+    : m_buffer(m_policy.bytes)
+{}
+
+//------------------------------------------------------------------------------
+BufferedFile::~BufferedFile()
+{
+    close();
+}
+
+//------------------------------------------------------------------------------
+bool BufferedFile::open(std::string const& path, bool const append)
+{
+    close();
+    m_size = 0u;
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC), 0666);
+    return m_fd >= 0;
+}
+
+//------------------------------------------------------------------------------
+void BufferedFile::close()
+{
+    if (m_fd < 0)
+        return ;
+
+    flush();
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+//------------------------------------------------------------------------------
+void BufferedFile::policy(FlushPolicy const& policy)
+{
+    flush();
+    m_policy = policy;
+    m_buffer.resize(std::max(m_policy.bytes, size_t(1u)));
+}
+
+//------------------------------------------------------------------------------
+void BufferedFile::write(const char* data, size_t const length, enum Severity const severity)
+{
+    if (m_fd < 0)
+        return ;
+
+    m_size += length;
+
+    // Not enough room: make some. Too large for the buffer: bypass it.
+    if (m_length + length > m_buffer.size())
+    {
+        flush();
+        if (length > m_buffer.size())
+        {
+            writeAll(data, length);
+            return ;
+        }
+    }
+
+    auto const now = std::chrono::steady_clock::now();
+    if (m_length == 0u)
+    {
+        m_oldest = now;
+    }
+    memcpy(m_buffer.data() + m_length, data, length);
+    m_length += length;
+
+    if ((m_length >= m_policy.bytes) || (rank(severity) >= rank(m_policy.severity)) ||
+        (now - m_oldest >= m_policy.interval))
+    {
+        flush();
+    }
+}
+
+//------------------------------------------------------------------------------
+void BufferedFile::flushIfExpired()
+{
+    if ((m_length != 0u) &&
+        (std::chrono::steady_clock::now() - m_oldest >= m_policy.interval))
+    {
+        flush();
+    }
+}
+
+//------------------------------------------------------------------------------
+void BufferedFile::flush()
+{
+    if (m_length == 0u)
+        return ;
+
+    writeAll(m_buffer.data(), m_length);
+    m_length = 0u;
+}
+
+//------------------------------------------------------------------------------
+void BufferedFile::writeAll(const char* data, size_t length)
+{
+    while ((length > 0u) && (m_fd >= 0))
+    {
+        ++m_syscalls;
+        Metrics::flush();
+        auto n = ::write(m_fd, data, length);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return ;
+        }
+        data += n;
+        length -= size_t(n);
+    }
+}
+
+} // namespace mylogger
@@ -0,0 +1,213 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Clock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define MYLOGGER_HAS_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#  include <intrin.h>
+#  define MYLOGGER_HAS_TSC
+#endif
+
+namespace mylogger {
+
+static std::atomic<ClockSource> s_source{ClockSource::Precise};
+static std::atomic<TimePrecision> s_precision{TimePrecision::Seconds};
+
+//! \brief Calibration of the TSC: a TSC value, the matching date and the
+//! duration of a tick.
+static uint64_t s_tsc_origin = 0u;
+static uint64_t s_ns_origin = 0u;
+static double s_ns_per_tick = 1.0;
+
+//! \brief Per-thread cache of the local time of the current second.
+static thread_local LocalTime t_local;
+
+//------------------------------------------------------------------------------
+//! \brief Read the realtime clock in nanoseconds.
+//------------------------------------------------------------------------------
+static uint64_t realtime(bool const coarse)
+{
+#if defined(_WIN32)
+    (void) coarse;
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+#else
+    struct timespec ts;
+#  if defined(CLOCK_REALTIME_COARSE)
+    clock_gettime(coarse ? CLOCK_REALTIME_COARSE : CLOCK_REALTIME, &ts);
+#  else
+    (void) coarse;
+    clock_gettime(CLOCK_REALTIME, &ts);
+#  endif
+    return uint64_t(ts.tv_sec) * 1000000000u + uint64_t(ts.tv_nsec);
+#endif
+}
+
+//------------------------------------------------------------------------------
+//! \brief Read the TSC.
+//------------------------------------------------------------------------------
+static uint64_t ticks()
+{
+#if defined(MYLOGGER_HAS_TSC)
+    return uint64_t(__rdtsc());
+#else
+    return 0u;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void Clock::digits(char* buffer, uint32_t value, size_t const count)
+{
+    for (size_t i = count; i > 0u; --i)
+    {
+        buffer[i - 1u] = char('0' + value % 10u);
+        value /= 10u;
+    }
+}
+
+//------------------------------------------------------------------------------
+void Clock::source(ClockSource source)
+{
+#if defined(MYLOGGER_HAS_TSC)
+    if (source == ClockSource::Tsc)
+    {
+        uint64_t const tsc0 = ticks();
+        uint64_t const ns0 = realtime(false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t const tsc1 = ticks();
+        uint64_t const ns1 = realtime(false);
+
+        s_tsc_origin = tsc1;
+        s_ns_origin = ns1;
+        s_ns_per_tick = (tsc1 > tsc0) ? double(ns1 - ns0) / double(tsc1 - tsc0) : 1.0;
+    }
+#else
+    if (source == ClockSource::Tsc)
+    {
+        source = ClockSource::Precise;
+    }
+#endif
+    s_source.store(source);
+}
+
+//------------------------------------------------------------------------------
+ClockSource Clock::source()
+{
+    return s_source.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void Clock::precision(TimePrecision const precision)
+{
+    s_precision.store(precision);
+}
+
+//------------------------------------------------------------------------------
+Timestamp Clock::now()
+{
+    switch (s_source.load(std::memory_order_relaxed))
+    {
+    case ClockSource::Tsc:
+        return { ticks(), true };
+    case ClockSource::Coarse:
+        return { realtime(true), false };
+    default:
+        return { realtime(false), false };
+    }
+}
+
+//------------------------------------------------------------------------------
+uint64_t Clock::nanoseconds(Timestamp const& when)
+{
+    if (!when.tsc)
+        return when.value;
+
+    int64_t const elapsed = int64_t(when.value - s_tsc_origin);
+    return uint64_t(int64_t(s_ns_origin) + int64_t(double(elapsed) * s_ns_per_tick));
+}
+
+//------------------------------------------------------------------------------
+size_t Clock::format(char* buffer, size_t const size, Timestamp const& when)
+{
+    static const size_t c_digits[] = { 0u, 3u, 6u, 9u };
+    static const uint32_t c_divisor[] = { 1000000000u, 1000000u, 1000u, 1u };
+
+    if (size == 0u)
+        return 0u;
+
+    uint64_t const ns = nanoseconds(when);
+    LocalTime const& time = local(time_t(ns / 1000000000u));
+
+    char text[32];
+    size_t n = 0u;
+    text[n++] = '[';
+    memcpy(text + n, time.hms, sizeof (time.hms));
+    n += sizeof (time.hms);
+
+    size_t const precision = size_t(s_precision.load(std::memory_order_relaxed));
+    if (c_digits[precision] != 0u)
+    {
+        text[n++] = '.';
+        digits(text + n, uint32_t(ns % 1000000000u) / c_divisor[precision],
+               c_digits[precision]);
+        n += c_digits[precision];
+    }
+    text[n++] = ']';
+
+    n = std::min(n, size - 1u);
+    memcpy(buffer, text, n);
+    buffer[n] = '\0';
+    return n;
+}
+
+//------------------------------------------------------------------------------
+LocalTime const& Clock::local(time_t const second)
+{
+    if (second != t_local.second)
+    {
+#if defined(_WIN32)
+        localtime_s(&t_local.tm, &second);
+#else
+        localtime_r(&second, &t_local.tm);
+#endif
+        struct tm const& tm = t_local.tm;
+        digits(t_local.hms, uint32_t(tm.tm_hour), 2u);
+        t_local.hms[2] = ':';
+        digits(t_local.hms + 3, uint32_t(tm.tm_min), 2u);
+        t_local.hms[5] = ':';
+        digits(t_local.hms + 6, uint32_t(tm.tm_sec), 2u);
+        digits(t_local.date, uint32_t(tm.tm_year + 1900), 4u);
+        t_local.date[4] = '/';
+        digits(t_local.date + 5, uint32_t(tm.tm_mon + 1), 2u);
+        t_local.date[7] = '/';
+        digits(t_local.date + 8, uint32_t(tm.tm_mday), 2u);
+        t_local.second = second;
+    }
+    return t_local;
+}
+
+} // namespace mylogger
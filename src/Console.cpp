@@ -0,0 +1,197 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "MyLogger/Console.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#if defined(_WIN32)
+#  include <io.h>
+#else
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
+namespace mylogger {
+
+//! \brief ANSI escape sequence of a severity, with its length.
+struct Color
+{
+    const char* text;
+    size_t length;
+};
+
+#define MYLOGGER_COLOR(text) { text, sizeof (text) - 1u }
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+//! \brief ANSI escape sequences of the severities.
+static const Color c_colors[MaxLoggerSeverity + 1] =
+{
+    [Severity::None]      = MYLOGGER_COLOR(""),
+    [Severity::Info]      = MYLOGGER_COLOR("\033[32m"),
+    [Severity::Debug]     = MYLOGGER_COLOR("\033[36m"),
+    [Severity::Warning]   = MYLOGGER_COLOR("\033[33m"),
+    [Severity::Failed]    = MYLOGGER_COLOR("\033[35m"),
+    [Severity::Error]     = MYLOGGER_COLOR("\033[31m"),
+    [Severity::Signal]    = MYLOGGER_COLOR("\033[1;31m"),
+    [Severity::Exception] = MYLOGGER_COLOR("\033[1;31m"),
+    [Severity::Catch]     = MYLOGGER_COLOR("\033[1;33m"),
+    [Severity::Fatal]     = MYLOGGER_COLOR("\033[1;37;41m")
+};
+#pragma GCC diagnostic pop
+
+#undef MYLOGGER_COLOR
+
+//! \brief Sequence restoring the default color.
+static const char c_reset[] = "\033[0m";
+
+#if defined(_WIN32)
+struct iovec { const void* iov_base; size_t iov_len; };
+#endif
+
+//------------------------------------------------------------------------------
+//! \brief Write the whole buffers (async-signal-safe).
+//------------------------------------------------------------------------------
+static void writeAll(int const fd, struct iovec* iov, int count)
+{
+    while (count > 0)
+    {
+#if defined(_WIN32)
+        auto n = ::write(fd, iov->iov_base, unsigned(iov->iov_len));
+#else
+        auto n = ::writev(fd, iov, count);
+#endif
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return ;
+        }
+
+        // Skip what has been written.
+        size_t written = size_t(n);
+        while ((count > 0) && (written >= iov->iov_len))
+        {
+            written -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = static_cast<char*>(const_cast<void*>(iov->iov_base)) + written;
+            iov->iov_len -= written;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+Console::Console(int const fd, ColorMode const mode)
+    : m_fd(fd), m_colored(colored(fd, mode))
+{}
+
+//------------------------------------------------------------------------------
+Console::~Console()
+{
+    flush();
+}
+
+//------------------------------------------------------------------------------
+bool Console::colored(int const fd, ColorMode const mode)
+{
+    if (mode != ColorMode::Auto)
+        return mode == ColorMode::Always;
+
+    const char* term = getenv("TERM");
+    return (::isatty(fd) != 0) && (getenv("NO_COLOR") == nullptr) &&
+           ((term == nullptr) || (strcmp(term, "dumb") != 0));
+}
+
+//------------------------------------------------------------------------------
+void Console::writeLine(int const fd, bool const colored, enum Severity const severity,
+                        const char* line, size_t length)
+{
+    if (!colored || (c_colors[severity].length == 0u))
+    {
+        struct iovec iov[1] = { { const_cast<char*>(line), length } };
+        writeAll(fd, iov, 1);
+        return ;
+    }
+
+    // The reset sequence comes before the end of line.
+    size_t const eol = ((length > 0u) && (line[length - 1u] == '\n')) ? 1u : 0u;
+    struct iovec iov[4] =
+    {
+        { const_cast<char*>(c_colors[severity].text), c_colors[severity].length },
+        { const_cast<char*>(line), length - eol },
+        { const_cast<char*>(c_reset), sizeof (c_reset) - 1u },
+        { const_cast<char*>("\n"), eol }
+    };
+    writeAll(fd, iov, 4);
+}
+
+//------------------------------------------------------------------------------
+void Console::append(enum Severity const severity, const char* line, size_t length)
+{
+    size_t const color = m_colored ? c_colors[severity].length : 0u;
+    size_t const reset = (color != 0u) ? sizeof (c_reset) - 1u : 0u;
+
+    if (m_length + color + length + reset > c_batch_size)
+    {
+        flush();
+        if (color + length + reset > c_batch_size)
+        {
+            write(severity, line, length);
+            return ;
+        }
+    }
+
+    if (color == 0u)
+    {
+        memcpy(m_batch + m_length, line, length);
+        m_length += length;
+        return ;
+    }
+
+    // The reset sequence comes before the end of line.
+    size_t const eol = ((length > 0u) && (line[length - 1u] == '\n')) ? 1u : 0u;
+    memcpy(m_batch + m_length, c_colors[severity].text, color);
+    m_length += color;
+    memcpy(m_batch + m_length, line, length - eol);
+    m_length += length - eol;
+    memcpy(m_batch + m_length, c_reset, reset);
+    m_length += reset;
+    memcpy(m_batch + m_length, "\n", eol);
+    m_length += eol;
+}
+
+//------------------------------------------------------------------------------
+void Console::flush()
+{
+    if (m_length == 0u)
+        return ;
+
+    struct iovec iov[1] = { { m_batch, m_length } };
+    writeAll(m_fd, iov, 1);
+    m_length = 0u;
+}
+
+} // namespace mylogger
@@ -0,0 +1,63 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#ifndef MYLOGGER_DECIMAL_HPP
+#  define MYLOGGER_DECIMAL_HPP
+
+#  include <cstddef>
+#  include <cstdint>
+#  include <cstring>
+
+namespace mylogger {
+
+//! \brief Largest number of chars written by decimal(): 20 digits and a sign.
+constexpr size_t c_decimal_size = 21u;
+
+//------------------------------------------------------------------------------
+//! \brief Write an integer in decimal, without final '\0'. Internal helper
+//! shared by the formatters of the library.
+//! \param buffer holding at least c_decimal_size chars.
+//! \param value the absolute value of the integer.
+//! \param negative if true, the value is preceded by '-'.
+//! \return the number of chars written.
+//------------------------------------------------------------------------------
+inline size_t decimal(char* buffer, uint64_t value, bool const negative = false)
+{
+    char digits[24];
+    char* p = digits + sizeof (digits);
+
+    do
+    {
+        *--p = char('0' + value % 10u);
+        value /= 10u;
+    } while (value != 0u);
+    if (negative)
+    {
+        *--p = '-';
+    }
+
+    size_t const length = size_t(digits + sizeof (digits) - p);
+    memcpy(buffer, p, length);
+    return length;
+}
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_DECIMAL_HPP */
@@ -0,0 +1,412 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Deferred.hpp"
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace mylogger {
+namespace deferred {
+
+// *****************************************************************************
+//! \brief Iterate over the arguments of an encoded log statement.
+// *****************************************************************************
+class Decoder
+{
+public:
+
+    Decoder(const char* record, size_t const length)
+        : m_cursor(record + sizeof (Header)), m_end(record + length)
+    {}
+
+    //! \brief Read the next argument. Return false if there is no more.
+    bool next(Type& type, int64_t& i, uint64_t& u, double& d,
+              const char*& s, const void*& p)
+    {
+        if (m_cursor >= m_end)
+            return false;
+
+        type = Type(*m_cursor++);
+        switch (type)
+        {
+        case Type::Int:
+            return read(&i, sizeof (i));
+        case Type::UInt:
+            return read(&u, sizeof (u));
+        case Type::Double:
+            return read(&d, sizeof (d));
+        case Type::Pointer:
+            return read(&p, sizeof (p));
+        case Type::String:
+            s = m_cursor;
+            m_cursor += strnlen(m_cursor, size_t(m_end - m_cursor)) + 1u;
+            return true;
+        default:
+            m_cursor = m_end;
+            return false;
+        }
+    }
+
+private:
+
+    bool read(void* value, size_t const size)
+    {
+        if (m_cursor + size > m_end)
+        {
+            m_cursor = m_end;
+            return false;
+        }
+        memcpy(value, m_cursor, size);
+        m_cursor += size;
+        return true;
+    }
+
+private:
+
+    const char* m_cursor;
+    const char* m_end;
+};
+
+// *****************************************************************************
+//! \brief Output of the formatter: never overflows, always '\0' terminated.
+// *****************************************************************************
+class Output
+{
+public:
+
+    Output(char* buffer, size_t const size)
+        : m_buffer(buffer), m_size(size), m_length(0u)
+    {
+        if (m_size > 0u)
+            m_buffer[0] = '\0';
+    }
+
+    void put(char const c)
+    {
+        if (m_length + 1u < m_size)
+        {
+            m_buffer[m_length++] = c;
+            m_buffer[m_length] = '\0';
+        }
+    }
+
+    //! \brief Format a single printf conversion.
+    template <class T>
+    void print(const char* spec, T const value)
+    {
+        if (m_length + 1u >= m_size)
+            return ;
+
+        size_t const remaining = m_size - m_length;
+        int n = snprintf(m_buffer + m_length, remaining, spec, value);
+        if (n > 0)
+        {
+            m_length += (size_t(n) < remaining) ? size_t(n) : remaining - 1u;
+        }
+    }
+
+    size_t length() const
+    {
+        return m_length;
+    }
+
+private:
+
+    char* m_buffer;
+    size_t const m_size;
+    size_t m_length;
+};
+
+//------------------------------------------------------------------------------
+//! \brief Convert an encoded integer to an int (for '*' width and precision).
+//------------------------------------------------------------------------------
+static int toInt(Type const type, int64_t const i, uint64_t const u)
+{
+    return (type == Type::Int) ? int(i) : (type == Type::UInt) ? int(u) : 0;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Format a signed integer conversion with its length modifier.
+//------------------------------------------------------------------------------
+static void printSigned(Output& out, const char* spec, const char* modifier, int64_t const v)
+{
+    if (modifier[0] == 'h' && modifier[1] == 'h')
+        out.print(spec, int(static_cast<signed char>(v)));
+    else if (modifier[0] == 'h')
+        out.print(spec, int(static_cast<short>(v)));
+    else if (modifier[0] == 'l' && modifier[1] == 'l')
+        out.print(spec, static_cast<long long>(v));
+    else if (modifier[0] == 'l')
+        out.print(spec, static_cast<long>(v));
+    else if (modifier[0] == 'j')
+        out.print(spec, static_cast<intmax_t>(v));
+    else if (modifier[0] == 'z')
+        out.print(spec, static_cast<ssize_t>(v));
+    else if (modifier[0] == 't')
+        out.print(spec, static_cast<ptrdiff_t>(v));
+    else
+        out.print(spec, static_cast<int>(v));
+}
+
+//------------------------------------------------------------------------------
+//! \brief Format an unsigned integer conversion with its length modifier.
+//------------------------------------------------------------------------------
+static void printUnsigned(Output& out, const char* spec, const char* modifier, uint64_t const v)
+{
+    if (modifier[0] == 'h' && modifier[1] == 'h')
+        out.print(spec, unsigned(static_cast<unsigned char>(v)));
+    else if (modifier[0] == 'h')
+        out.print(spec, unsigned(static_cast<unsigned short>(v)));
+    else if (modifier[0] == 'l' && modifier[1] == 'l')
+        out.print(spec, static_cast<unsigned long long>(v));
+    else if (modifier[0] == 'l')
+        out.print(spec, static_cast<unsigned long>(v));
+    else if (modifier[0] == 'j')
+        out.print(spec, static_cast<uintmax_t>(v));
+    else if (modifier[0] == 'z')
+        out.print(spec, static_cast<size_t>(v));
+    else if (modifier[0] == 't')
+        out.print(spec, static_cast<size_t>(v));
+    else
+        out.print(spec, static_cast<unsigned>(v));
+}
+
+//------------------------------------------------------------------------------
+size_t format(char* buffer, size_t const size, const char* format,
+              const char* record, size_t const length)
+{
+    Output out(buffer, size);
+    Decoder args(record, length);
+    const char* f = format;
+
+    Type type = Type::Int;
+    int64_t i = 0; uint64_t u = 0u; double d = 0.0;
+    const char* s = nullptr; const void* p = nullptr;
+
+    while (*f != '\0')
+    {
+        if (*f != '%')
+        {
+            out.put(*f++);
+            continue;
+        }
+        if (f[1] == '%')
+        {
+            out.put('%');
+            f += 2;
+            continue;
+        }
+
+        // Rebuild the conversion specification with '*' replaced by the
+        // values of their arguments: "%[flags][width][.precision][length]conv"
+        char spec[64];
+        size_t n = 0u;
+        spec[n++] = *f++;
+        while ((*f != '\0') && (strchr("-+ #0'", *f) != nullptr) && (n < 8u))
+            spec[n++] = *f++;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            if ((pass == 1) && (*f == '.'))
+                spec[n++] = *f++;
+            if (*f == '*')
+            {
+                ++f;
+                int v = args.next(type, i, u, d, s, p) ? toInt(type, i, u) : 0;
+                n += size_t(snprintf(spec + n, 16u, "%d", v));
+            }
+            else
+            {
+                while ((*f >= '0') && (*f <= '9') && (n < 40u))
+                    spec[n++] = *f++;
+            }
+        }
+        const char* modifier = spec + n;
+        while ((*f != '\0') && (strchr("hlLjzt", *f) != nullptr) && (n < 44u))
+            spec[n++] = *f++;
+        spec[n] = '\0';
+        char const conversion = *f;
+        if (conversion == '\0')
+            break;
+        spec[n++] = *f++;
+        spec[n] = '\0';
+
+        // Missing argument or wrong type: do not let printf read garbage.
+        if (!args.next(type, i, u, d, s, p))
+        {
+            out.put('?');
+            continue;
+        }
+        switch (conversion)
+        {
+        case 'd': case 'i': case 'c':
+            if (type == Type::Int) printSigned(out, spec, modifier, i);
+            else if (type == Type::UInt) printSigned(out, spec, modifier, int64_t(u));
+            else out.put('?');
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            if (type == Type::UInt) printUnsigned(out, spec, modifier, u);
+            else if (type == Type::Int) printUnsigned(out, spec, modifier, uint64_t(i));
+            else out.put('?');
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (type != Type::Double) out.put('?');
+            else if (modifier[0] == 'L') out.print(spec, static_cast<long double>(d));
+            else out.print(spec, d);
+            break;
+        case 's':
+            if (type == Type::String) out.print(spec, s);
+            else if ((type == Type::Pointer) && (p == nullptr)) out.print(spec, "(null)");
+            else out.put('?');
+            break;
+        case 'p':
+            if (type == Type::Pointer) out.print(spec, p);
+            else out.put('?');
+            break;
+        default:
+            // %n and unknown conversions are not supported.
+            out.put('?');
+            break;
+        }
+    }
+
+    return out.length();
+}
+
+//------------------------------------------------------------------------------
+//! \brief Store a signed integer argument read with its length modifier.
+//------------------------------------------------------------------------------
+static void encodeSigned(Encoder& enc, const char* modifier, va_list& params)
+{
+    if (modifier[0] == 'l' && modifier[1] == 'l')
+        enc.arg(va_arg(params, long long));
+    else if (modifier[0] == 'l')
+        enc.arg(va_arg(params, long));
+    else if (modifier[0] == 'j')
+        enc.arg(va_arg(params, intmax_t));
+    else if (modifier[0] == 'z')
+        enc.arg(va_arg(params, ssize_t));
+    else if (modifier[0] == 't')
+        enc.arg(va_arg(params, ptrdiff_t));
+    else
+        enc.arg(va_arg(params, int));
+}
+
+//------------------------------------------------------------------------------
+//! \brief Store an unsigned integer argument read with its length modifier.
+//------------------------------------------------------------------------------
+static void encodeUnsigned(Encoder& enc, const char* modifier, va_list& params)
+{
+    if (modifier[0] == 'l' && modifier[1] == 'l')
+        enc.arg(va_arg(params, unsigned long long));
+    else if (modifier[0] == 'l')
+        enc.arg(va_arg(params, unsigned long));
+    else if (modifier[0] == 'j')
+        enc.arg(va_arg(params, uintmax_t));
+    else if (modifier[0] == 'z')
+        enc.arg(va_arg(params, size_t));
+    else if (modifier[0] == 't')
+        enc.arg(uint64_t(va_arg(params, ptrdiff_t)));
+    else
+        enc.arg(va_arg(params, unsigned));
+}
+
+//------------------------------------------------------------------------------
+size_t vencode(char* buffer, size_t const size, Header const& header,
+               const char* format, va_list params)
+{
+    Encoder enc(buffer, size);
+    enc.header(header);
+
+    // va_list may be an array type: work on a copy to pass it by reference.
+    va_list args;
+    va_copy(args, params);
+
+    const char* f = format;
+    while (*f != '\0')
+    {
+        if (*f++ != '%')
+            continue;
+        if (*f == '%')
+        {
+            ++f;
+            continue;
+        }
+
+        // Same grammar than format(): "%[flags][width][.precision][length]conv"
+        while ((*f != '\0') && (strchr("-+ #0'", *f) != nullptr))
+            ++f;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            if ((pass == 1) && (*f == '.'))
+                ++f;
+            if (*f == '*')
+            {
+                ++f;
+                enc.arg(va_arg(args, int));
+            }
+            else
+            {
+                while ((*f >= '0') && (*f <= '9'))
+                    ++f;
+            }
+        }
+        char modifier[3] = { '\0', '\0', '\0' };
+        for (size_t n = 0u; (*f != '\0') && (strchr("hlLjzt", *f) != nullptr); ++f)
+        {
+            if (n < 2u)
+                modifier[n++] = *f;
+        }
+
+        switch (*f)
+        {
+        case 'd': case 'i': case 'c':
+            encodeSigned(enc, modifier, args);
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            encodeUnsigned(enc, modifier, args);
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            if (modifier[0] == 'L')
+                enc.arg(va_arg(args, long double));
+            else
+                enc.arg(va_arg(args, double));
+            break;
+        case 's':
+            enc.arg(va_arg(args, const char*));
+            break;
+        case 'p': case 'n':
+            enc.arg(va_arg(args, const void*));
+            break;
+        default:
+            // Unknown conversion: the following arguments cannot be located.
+            va_end(args);
+            return enc.length();
+        }
+        ++f;
+    }
+
+    va_end(args);
+    return enc.length();
+}
+
+} // namespace deferred
+} // namespace mylogger
@@ -0,0 +1,293 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "MyLogger/Fields.hpp"
+#include "MyLogger/Metrics.hpp"
+#include "Decimal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace mylogger {
+
+static std::atomic<FieldFormat> s_format{FieldFormat::Text};
+
+// *****************************************************************************
+//! \brief What to do with each char of a string value.
+// *****************************************************************************
+struct EscapeTable
+{
+    EscapeTable()
+    {
+        for (int c = 0; c < 0x20; ++c)
+        {
+            escape[c] = 'u';
+        }
+        escape[int('"')] = '"';
+        escape[int('\\')] = '\\';
+        escape[int('\b')] = 'b';
+        escape[int('\f')] = 'f';
+        escape[int('\n')] = 'n';
+        escape[int('\r')] = 'r';
+        escape[int('\t')] = 't';
+
+        for (int c = 0; c < 256; ++c)
+        {
+            quote[c] = (escape[c] != 0);
+        }
+        quote[int(' ')] = true;
+        quote[int('=')] = true;
+    }
+
+    //! \brief 0 when the char is copied as is, else the letter following the
+    //! backslash of its escape sequence ('u' for "\u00XX").
+    char escape[256] = {};
+    //! \brief The char forces the quotes around logfmt values.
+    bool quote[256] = {};
+};
+
+static const EscapeTable c_table;
+
+//------------------------------------------------------------------------------
+void Fields::format(FieldFormat const format)
+{
+    s_format.store(format);
+}
+
+//------------------------------------------------------------------------------
+FieldFormat Fields::format()
+{
+    return s_format.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+size_t Fields::escape(char* output, const char* input, size_t const length)
+{
+    static const char c_hex[] = "0123456789abcdef";
+    size_t n = 0u;
+    size_t i = 0u;
+
+    for (;;)
+    {
+        // Copy the run of plain chars at once.
+        size_t run = i;
+        while ((run < length) && (c_table.escape[uint8_t(input[run])] == 0))
+        {
+            ++run;
+        }
+        memcpy(output + n, input + i, run - i);
+        n += run - i;
+        if (run == length)
+            return n;
+
+        uint8_t const c = uint8_t(input[run]);
+        output[n++] = '\\';
+        output[n++] = c_table.escape[c];
+        if (c_table.escape[c] == 'u')
+        {
+            output[n++] = '0';
+            output[n++] = '0';
+            output[n++] = c_hex[c >> 4];
+            output[n++] = c_hex[c & 15u];
+        }
+        i = run + 1u;
+    }
+}
+
+//------------------------------------------------------------------------------
+void Fields::append(const char* data, size_t const length)
+{
+    reserve(length);
+    size_t const n = std::min(length, m_line.size() - 2u - m_length);
+    memcpy(m_line.data() + m_length, data, n);
+    m_length += n;
+    m_truncated |= (n < length);
+}
+
+//------------------------------------------------------------------------------
+void Fields::string(const char* value, size_t length)
+{
+    bool quoted = (m_format == FieldFormat::Json) || (length == 0u);
+    for (size_t i = 0u; (i < length) && !quoted; ++i)
+    {
+        quoted = c_table.quote[uint8_t(value[i])];
+    }
+    if (!quoted)
+    {
+        append(value, length);
+        return ;
+    }
+
+    // Out of memory: the value is truncated. A previous truncated append()
+    // may even have left no room for the quotes.
+    if (!reserve(6u * length + 2u))
+    {
+        m_truncated = true;
+        if (m_length + 4u > m_line.size())
+            return ;
+        length = std::min(length, (m_line.size() - 4u - m_length) / 6u);
+    }
+    char* p = m_line.data() + m_length;
+    *p++ = '"';
+    p += escape(p, value, length);
+    *p++ = '"';
+    m_length = size_t(p - m_line.data());
+}
+
+//------------------------------------------------------------------------------
+void Fields::key(const char* key)
+{
+    if (m_format == FieldFormat::Json)
+    {
+        if (m_count++ != 0u)
+        {
+            append(",", 1u);
+        }
+        string(key, strlen(key));
+        append(":", 1u);
+    }
+    else
+    {
+        // In Text format, fields follow the message.
+        if ((m_count++ != 0u) || (m_format == FieldFormat::Text))
+        {
+            append(" ", 1u);
+        }
+        append(key, strlen(key));
+        append("=", 1u);
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t Fields::begin(Site const& site, Timestamp const& when, const char* message)
+{
+    size_t const start = m_length;
+
+    if (m_format == FieldFormat::Text)
+    {
+        append(message, strlen(message));
+        return start;
+    }
+
+    if (m_format == FieldFormat::Json)
+    {
+        append("{", 1u);
+    }
+    add("time", Clock::nanoseconds(when));
+    if (site.severity != None)
+    {
+        // "[INFO]" without its brackets.
+        const char* name = ILogger::severityName(site.severity);
+        key("level");
+        string(name + 1, strlen(name) - 2u);
+    }
+    if (site.file != nullptr)
+    {
+        add("file", site.file);
+        add("line", site.line);
+    }
+    add("msg", message);
+    return start;
+}
+
+//------------------------------------------------------------------------------
+size_t Fields::end()
+{
+    if (m_format == FieldFormat::Json)
+    {
+        append("}", 1u);
+    }
+    if (m_truncated)
+    {
+        Metrics::truncated();
+    }
+    return m_length;
+}
+
+//------------------------------------------------------------------------------
+void Fields::add(const char* name, bool const value)
+{
+    key(name);
+    if (value)
+        append("true", 4u);
+    else
+        append("false", 5u);
+}
+
+//------------------------------------------------------------------------------
+void Fields::add(const char* name, char const value)
+{
+    key(name);
+    string(&value, 1u);
+}
+
+//------------------------------------------------------------------------------
+void Fields::add(const char* name, const char* value)
+{
+    key(name);
+    if (value == nullptr)
+        append("null", 4u);
+    else
+        string(value, strlen(value));
+}
+
+//------------------------------------------------------------------------------
+void Fields::add(const char* name, std::string const& value)
+{
+    key(name);
+    string(value.data(), value.size());
+}
+
+//------------------------------------------------------------------------------
+void Fields::integer(const char* name, uint64_t value, bool const negative)
+{
+    char text[c_decimal_size];
+    size_t const length = decimal(text, value, negative);
+
+    key(name);
+    append(text, length);
+}
+
+//------------------------------------------------------------------------------
+void Fields::real(const char* name, double const value)
+{
+    char text[32];
+    int n;
+
+    key(name);
+    if (!std::isfinite(value) && (m_format == FieldFormat::Json))
+    {
+        append("null", 4u);
+        return ;
+    }
+
+    // Shortest of the usual precisions giving back the same value.
+    n = snprintf(text, sizeof (text), "%.15g", value);
+    if (strtod(text, nullptr) != value)
+    {
+        n = snprintf(text, sizeof (text), "%.17g", value);
+    }
+    append(text, (n < 0) ? 0u : std::min(size_t(n), sizeof (text) - 1u));
+}
+
+} // namespace mylogger
@@ -0,0 +1,225 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/FlightRecorder.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace mylogger {
+
+FlightRecorder::Slot* FlightRecorder::s_slots = nullptr;
+uint64_t FlightRecorder::s_mask = 0u;
+std::atomic<uint64_t> FlightRecorder::s_cursor{0u};
+std::atomic<bool> FlightRecorder::s_dumping{false};
+char FlightRecorder::s_path[FlightRecorder::c_max_path] = { '\0' };
+std::atomic<int> FlightRecorder::s_console{-1};
+std::atomic<bool> FlightRecorder::s_colored{false};
+
+//! \brief First line of the dump file.
+static const char c_banner[] = "======= Flight recorder: last log lines =======\n";
+
+//! \brief Signals dumping the flight recorder.
+#if defined(_WIN32)
+static const int c_signals[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+#else
+static const int c_signals[] = { SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL };
+#endif
+
+//------------------------------------------------------------------------------
+//! \brief Write the whole data (async-signal-safe).
+//------------------------------------------------------------------------------
+static void writeAll(int const fd, const char* data, size_t length)
+{
+    while (length > 0u)
+    {
+        auto n = ::write(fd, data, length);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return ;
+        }
+        data += n;
+        length -= size_t(n);
+    }
+}
+
+//------------------------------------------------------------------------------
+//! \brief Handler of fatal signals: dump then die with the default action.
+//------------------------------------------------------------------------------
+static void onSignal(int const signum)
+{
+    int const error = errno;
+    FlightRecorder::dump();
+    errno = error;
+
+    signal(signum, SIG_DFL);
+    raise(signum);
+}
+
+//------------------------------------------------------------------------------
+bool FlightRecorder::start(std::string const& path, size_t const lines,
+                           enum Severity const severity)
+{
+    if (path.size() >= c_max_path)
+        return false;
+
+    stop();
+
+    size_t size = 1u;
+    while (size < lines)
+    {
+        size <<= 1;
+    }
+    s_slots = new Slot[size];
+    for (size_t i = 0u; i < size; ++i)
+    {
+        s_slots[i].seq.store(0u, std::memory_order_relaxed);
+    }
+    s_mask = size - 1u;
+    s_cursor.store(0u);
+    memcpy(s_path, path.c_str(), path.size() + 1u);
+
+    ILogger::s_recorded.store(rank(severity));
+    ILogger::threshold(ILogger::threshold());
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void FlightRecorder::stop()
+{
+    ILogger::s_recorded.store(int(MaxLoggerSeverity) + 1);
+    ILogger::threshold(ILogger::threshold());
+
+    delete[] s_slots;
+    s_slots = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void FlightRecorder::console(int const fd, ColorMode const mode)
+{
+    s_colored.store((fd >= 0) && Console::colored(fd, mode));
+    s_console.store(fd);
+}
+
+//------------------------------------------------------------------------------
+void FlightRecorder::record(const char* line, size_t const length,
+                            enum Severity const severity)
+{
+    uint64_t const index = s_cursor.fetch_add(1u, std::memory_order_relaxed);
+    Slot& slot = s_slots[index & s_mask];
+
+    slot.seq.store(2u * index + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.length = uint32_t(std::min(length, size_t(c_line_size)));
+    slot.severity = uint8_t(severity);
+    memcpy(slot.text, line, slot.length);
+    slot.seq.store(2u * index + 2u, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+bool FlightRecorder::dump()
+{
+    if ((s_slots == nullptr) || s_dumping.exchange(true))
+        return false;
+
+    int fd = ::open(s_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+    {
+        s_dumping = false;
+        return false;
+    }
+
+    int const console = s_console.load();
+    bool const colored = s_colored.load();
+
+    writeAll(fd, c_banner, sizeof (c_banner) - 1u);
+    if (console >= 0)
+    {
+        writeAll(console, c_banner, sizeof (c_banner) - 1u);
+    }
+
+    uint64_t const end = s_cursor.load(std::memory_order_acquire);
+    uint64_t const size = s_mask + 1u;
+    char text[c_line_size];
+
+    for (uint64_t index = (end > size) ? end - size : 0u; index < end; ++index)
+    {
+        // Seqlock read: skip the slot if it is being written or has been
+        // reused meanwhile.
+        Slot const& slot = s_slots[index & s_mask];
+        if (slot.seq.load(std::memory_order_acquire) != 2u * index + 2u)
+            continue;
+        size_t const length = std::min(size_t(slot.length), size_t(c_line_size));
+        enum Severity const severity = Severity(std::min(int(slot.severity),
+                                                         int(MaxLoggerSeverity)));
+        memcpy(text, slot.text, length);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != 2u * index + 2u)
+            continue;
+
+        writeAll(fd, text, length);
+        if ((length == c_line_size) && (text[length - 1u] != '\n'))
+        {
+            writeAll(fd, "\n", 1u);
+        }
+        if (console >= 0)
+        {
+            Console::writeLine(console, colored, severity, text, length);
+            if ((length == c_line_size) && (text[length - 1u] != '\n'))
+            {
+                writeAll(console, "\n", 1u);
+            }
+        }
+    }
+
+    ::close(fd);
+    s_dumping = false;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void FlightRecorder::installSignalHandlers()
+{
+    for (int const signum: c_signals)
+    {
+#if defined(_WIN32)
+        signal(signum, onSignal);
+#else
+        struct sigaction action;
+        memset(&action, 0, sizeof (action));
+        action.sa_handler = onSignal;
+        sigemptyset(&action.sa_mask);
+        // The handler raises the signal again with its default action.
+        action.sa_flags = SA_RESETHAND | SA_NODEFER;
+        sigaction(signum, &action, nullptr);
+#endif
+    }
+}
+
+} // namespace mylogger
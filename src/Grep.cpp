@@ -0,0 +1,435 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Grep.hpp"
+#include "MyLogger/ILogger.hpp"
+#include "MyLogger/Sequence.hpp"
+#include <cstring>
+#include <fstream>
+
+namespace mylogger {
+
+constexpr int64_t Grep::c_day;
+
+//! \brief A minute in nanoseconds.
+static const int64_t c_minute = 60000000000;
+
+//! \brief Number of last covered bytes checked by LogIndex::covers().
+static const size_t c_check_size = 4096u;
+
+//! \brief First bytes of an index file.
+static const char c_magic[8] = { 'M', 'L', 'G', 'I', 'D', 'X', '1', '\0' };
+
+// *****************************************************************************
+//! \brief Beginning of an index file, followed by its entries.
+// *****************************************************************************
+struct IndexHeader
+{
+    char magic[8];
+    uint64_t size;
+    uint64_t check;
+    uint64_t count;
+};
+
+//------------------------------------------------------------------------------
+static bool isDigit(char const c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+//------------------------------------------------------------------------------
+static int64_t twoDigits(const char* p)
+{
+    return int64_t(p[0] - '0') * 10 + int64_t(p[1] - '0');
+}
+
+//------------------------------------------------------------------------------
+//! \brief FNV-1a hash of the last bytes before the given size.
+//------------------------------------------------------------------------------
+static uint64_t checksum(const char* data, size_t const size)
+{
+    uint64_t hash = 14695981039346656037u;
+    size_t const start = (size > c_check_size) ? size - c_check_size : 0u;
+    for (size_t i = start; i < size; ++i)
+    {
+        hash ^= uint8_t(data[i]);
+        hash *= 1099511628211u;
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+LineInfo LineInfo::parse(const char* line, size_t const length, bool const location)
+{
+    LineInfo info = { -1, None, nullptr, 0u };
+    const char* const end = line + length;
+
+    Stamp stamp;
+    const char* p = line + Sequence::parse(line, length, stamp);
+
+    // "[HH:MM:SS" followed by an optional fraction of second and ']'
+    if ((end - p < 10) || (p[0] != '[') || (p[3] != ':') || (p[6] != ':') ||
+        !isDigit(p[1]) || !isDigit(p[2]) || !isDigit(p[4]) || !isDigit(p[5]) ||
+        !isDigit(p[7]) || !isDigit(p[8]))
+    {
+        return info;
+    }
+    int64_t time = ((twoDigits(p + 1) * 60 + twoDigits(p + 4)) * 60 +
+                    twoDigits(p + 7)) * 1000000000;
+    p += 9;
+    if ((p < end) && (*p == '.'))
+    {
+        static const int64_t c_scales[10] =
+        {
+            1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+        };
+        int64_t fraction = 0;
+        size_t digits = 0u;
+        for (++p; (p < end) && isDigit(*p); ++p)
+        {
+            if (digits < 9u)
+            {
+                fraction = fraction * 10 + int64_t(*p - '0');
+                ++digits;
+            }
+        }
+        time += fraction * c_scales[digits];
+    }
+    if ((p >= end) || (*p != ']'))
+        return info;
+    info.time = time;
+    ++p;
+
+    // Severity tag
+    if ((p < end) && (*p == '['))
+    {
+        for (int i = Info; i <= MaxLoggerSeverity; ++i)
+        {
+            const char* tag = ILogger::severityName(Severity(i));
+            if ((end - p < 2) || (p[1] != tag[1]))
+                continue;
+            size_t const size = strlen(tag);
+            if ((size_t(end - p) >= size) && (memcmp(p, tag, size) == 0))
+            {
+                info.severity = Severity(i);
+                p += size;
+                break;
+            }
+        }
+    }
+
+    // "[file::line]", not to be confused with a message starting by '['
+    if (location && (p < end) && (*p == '['))
+    {
+        const char* close = static_cast<const char*>(memchr(p, ']', size_t(end - p)));
+        for (const char* q = p + 1; (close != nullptr) && (q + 1 < close); ++q)
+        {
+            if ((q[0] == ':') && (q[1] == ':'))
+            {
+                info.location = p + 1;
+                info.location_length = size_t(close - p - 1);
+                break;
+            }
+        }
+    }
+    return info;
+}
+
+//------------------------------------------------------------------------------
+void LogIndex::update(const char* data, size_t const size)
+{
+    if (!covers(data, size))
+    {
+        m_entries.clear();
+        m_size = 0u;
+    }
+
+    size_t position = size_t(m_size);
+    while (position < size)
+    {
+        const char* line = data + position;
+        const char* eol = static_cast<const char*>(memchr(line, '\n', size - position));
+        if (eol == nullptr)
+            break; // The last line is still being written
+
+        size_t const length = size_t(eol + 1 - line);
+        LineInfo const info = LineInfo::parse(line, length, false);
+
+        // Lines without time belong to the run of the previous line.
+        int32_t minute = m_entries.empty() ? -1 : m_entries.back().minute;
+        if (info.time >= 0)
+        {
+            minute = int32_t(info.time / c_minute);
+        }
+        if (m_entries.empty() || (m_entries.back().minute != minute))
+        {
+            m_entries.push_back({ uint64_t(position), minute, 0u });
+        }
+        m_entries.back().severities |= 1u << info.severity;
+        position += length;
+    }
+
+    m_size = position;
+    m_check = checksum(data, position);
+}
+
+//------------------------------------------------------------------------------
+bool LogIndex::covers(const char* data, size_t const size) const
+{
+    return (m_size <= size) && (checksum(data, size_t(m_size)) == m_check);
+}
+
+//------------------------------------------------------------------------------
+bool LogIndex::load(std::string const& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    IndexHeader header;
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof (header)) ||
+        (memcmp(header.magic, c_magic, sizeof (c_magic)) != 0))
+    {
+        return false;
+    }
+
+    // A truncated or corrupt sidecar must not make us allocate its count.
+    std::streamoff const here = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff const left = file.tellg() - here;
+    file.seekg(here);
+    if ((left < 0) || (header.count > uint64_t(left) / sizeof (Entry)))
+    {
+        return false;
+    }
+
+    std::vector<Entry> entries(header.count);
+    if ((header.count != 0u) &&
+        !file.read(reinterpret_cast<char*>(entries.data()),
+                   std::streamsize(header.count * sizeof (Entry))))
+    {
+        return false;
+    }
+
+    m_entries.swap(entries);
+    m_size = header.size;
+    m_check = header.check;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool LogIndex::save(std::string const& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    IndexHeader header;
+
+    memcpy(header.magic, c_magic, sizeof (c_magic));
+    header.size = m_size;
+    header.check = m_check;
+    header.count = m_entries.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof (header));
+    file.write(reinterpret_cast<const char*>(m_entries.data()),
+               std::streamsize(m_entries.size() * sizeof (Entry)));
+    return bool(file);
+}
+
+//------------------------------------------------------------------------------
+std::string LogIndex::path(std::string const& log)
+{
+    return log + ".idx";
+}
+
+//------------------------------------------------------------------------------
+Grep::Grep(const char* data, size_t const size, Query const& query,
+           LogIndex const* index)
+    : m_data(data), m_query(query),
+      m_timed((query.from != 0) || (query.to != c_day - 1)),
+      m_severities(0u)
+{
+    for (int i = None; i <= MaxLoggerSeverity; ++i)
+    {
+        if (rank(Severity(i)) >= rank(query.severity))
+        {
+            m_severities |= 1u << i;
+        }
+    }
+
+    if (!m_query.text.empty())
+    {
+        m_needle = m_query.text;
+    }
+    else if (!m_query.location.empty())
+    {
+        // "[main.cpp::" for a file, "[main.cpp::12]" for a log statement
+        bool const statement = (m_query.location.find("::") != std::string::npos);
+        m_needle = '[' + m_query.location + (statement ? "]" : "::");
+    }
+
+    if ((index == nullptr) || !index->covers(data, size))
+    {
+        region(0u, size);
+        return ;
+    }
+
+    auto const& entries = index->entries();
+    for (size_t i = 0u; i < entries.size(); ++i)
+    {
+        size_t const begin = size_t(entries[i].offset);
+        size_t const end = (i + 1u < entries.size()) ? size_t(entries[i + 1u].offset)
+                                                     : index->size();
+        if (selected(entries[i]))
+        {
+            region(begin, end);
+        }
+        else
+        {
+            m_skipped += end - begin;
+        }
+    }
+    region(index->size(), size);
+}
+
+//------------------------------------------------------------------------------
+void Grep::region(size_t const begin, size_t const end)
+{
+    if (begin >= end)
+        return ;
+
+    // Contiguous runs are searched at once.
+    if (!m_regions.empty() && (m_regions.back().second == begin))
+    {
+        m_regions.back().second = end;
+    }
+    else
+    {
+        m_regions.push_back(std::make_pair(begin, end));
+    }
+    if (m_regions.size() == 1u)
+    {
+        m_position = m_regions[0].first;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool Grep::inRange(int64_t const time) const
+{
+    if (m_query.from <= m_query.to)
+        return (time >= m_query.from) && (time <= m_query.to);
+    return (time >= m_query.from) || (time <= m_query.to);
+}
+
+//------------------------------------------------------------------------------
+bool Grep::selected(LogIndex::Entry const& entry) const
+{
+    if ((m_query.severity != None) && ((entry.severities & m_severities) == 0u))
+        return false;
+    if (!m_timed)
+        return true;
+    if (entry.minute < 0)
+        return false;
+
+    // The minute intersects the range of the query.
+    int64_t const first = int64_t(entry.minute) * c_minute;
+    int64_t const last = first + c_minute - 1;
+    if (m_query.from <= m_query.to)
+        return (first <= m_query.to) && (last >= m_query.from);
+    return (last >= m_query.from) || (first <= m_query.to);
+}
+
+//------------------------------------------------------------------------------
+bool Grep::match(const char* line, size_t const length) const
+{
+    if ((m_query.severity != None) || m_timed || !m_query.location.empty())
+    {
+        LineInfo const info = LineInfo::parse(line, length, !m_query.location.empty());
+        if (rank(info.severity) < rank(m_query.severity))
+            return false;
+        if (m_timed && ((info.time < 0) || !inRange(info.time)))
+            return false;
+        if (!m_query.location.empty())
+        {
+            size_t const size = m_query.location.size();
+            if ((info.location == nullptr) || (info.location_length < size) ||
+                (memcmp(info.location, m_query.location.data(), size) != 0))
+            {
+                return false;
+            }
+            // Either the log statement, either a line of the file
+            if ((info.location_length != size) &&
+                ((info.location_length < size + 2u) ||
+                 (memcmp(info.location + size, "::", 2u) != 0)))
+            {
+                return false;
+            }
+        }
+    }
+
+    return m_query.text.empty() ||
+        (memmem(line, length, m_query.text.data(), m_query.text.size()) != nullptr);
+}
+
+//------------------------------------------------------------------------------
+bool Grep::next(Line& line)
+{
+    while (m_region < m_regions.size())
+    {
+        size_t const end = m_regions[m_region].second;
+        while (m_position < end)
+        {
+            const char* const from = m_data + m_position;
+            const char* begin = from;
+
+            // Jump to the next occurrence, then back to the start of its line.
+            if (!m_needle.empty())
+            {
+                const char* hit = static_cast<const char*>(
+                    memmem(from, end - m_position, m_needle.data(), m_needle.size()));
+                if (hit == nullptr)
+                {
+                    m_position = end;
+                    break;
+                }
+                // memrchr() is glibc only: scan backward by hand.
+                begin = hit;
+                while ((begin != from) && (begin[-1] != '\n'))
+                {
+                    --begin;
+                }
+            }
+
+            size_t const left = size_t(m_data + end - begin);
+            const char* eol = static_cast<const char*>(memchr(begin, '\n', left));
+            size_t const length = (eol == nullptr) ? left : size_t(eol + 1 - begin);
+            m_position = size_t(begin - m_data) + length;
+            if (match(begin, length))
+            {
+                line.text = begin;
+                line.length = length;
+                return true;
+            }
+        }
+
+        if (++m_region < m_regions.size())
+        {
+            m_position = m_regions[m_region].first;
+        }
+    }
+    return false;
+}
+
+} // namespace mylogger
@@ -0,0 +1,102 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/IFileLogger.hpp"
+#include "MyLogger/File.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+bool IFileLogger::logPath(std::string const& filename, project::Info const& info,
+                          std::string& path)
+{
+    // Distinguish behavior between simple file and absolute path.
+    std::string dir = File::dirName(filename);
+    path = filename;
+    if (dir.empty())
+    {
+        dir = info.tmp_path;
+        path = dir + filename;
+    }
+
+    // Call it before Logger constructor
+    if (!File::mkdir(dir))
+    {
+        std::cerr << "Failed creating the temporary directory '"
+                  << info.tmp_path << "'" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+size_t IFileLogger::formatHeader(char* buffer, size_t const size, project::Info const& info)
+{
+    char date[32];
+
+    currentDate(date, sizeof (date));
+    int n = snprintf(buffer, size,
+                     "======================================================\n"
+                     "  %s %s %u.%u - Event log - %s\n"
+                     "  git branch: %s\n"
+                     "  git SHA1: %s\n"
+                     "======================================================\n\n",
+                     info.project_name.c_str(),
+                     info.debug ? "Debug" : "Release",
+                     info.major_version,
+                     info.minor_version,
+                     date,
+                     info.git_branch.c_str(),
+                     info.git_sha1.c_str());
+    return (n < 0) ? 0u : std::min(size_t(n), size - 1u);
+}
+
+//------------------------------------------------------------------------------
+size_t IFileLogger::formatFooter(char* buffer, size_t const size, project::Info const& info)
+{
+    char time[32];
+
+    currentTime(time, sizeof (time));
+    int n = snprintf(buffer, size,
+                     "\n======================================================\n"
+                     "  %s log closed at %s\n"
+                     "======================================================\n\n",
+                     info.project_name.c_str(),
+                     time);
+    return (n < 0) ? 0u : std::min(size_t(n), size - 1u);
+}
+
+//------------------------------------------------------------------------------
+void IFileLogger::writeHeader(project::Info const& info)
+{
+    char buffer[c_buffer_size];
+    dispatch(nullptr, None, buffer, formatHeader(buffer, sizeof (buffer), info), 0u);
+}
+
+//------------------------------------------------------------------------------
+void IFileLogger::writeFooter(project::Info const& info)
+{
+    char buffer[c_buffer_size];
+    dispatch(nullptr, None, buffer, formatFooter(buffer, sizeof (buffer), info), 0u);
+}
+
+} // namespace mylogger
@@ -19,71 +19,387 @@
 //=====================================================================
 
 #include "MyLogger/ILogger.hpp"
+#include "MyLogger/Site.hpp"
+#include "MyLogger/Deferred.hpp"
+#include "MyLogger/FlightRecorder.hpp"
+#include "MyLogger/LineBuffer.hpp"
+#include "MyLogger/Metrics.hpp"
+#include "MyLogger/RateLimit.hpp"
+#include "MyLogger/Sequence.hpp"
 #include <cstdarg>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 
 namespace mylogger {
 
+//------------------------------------------------------------------------------
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+static const char *c_str_severity[Severity::MaxLoggerSeverity + 1] =
+{
+    [Severity::None]      = "",
+    [Severity::Info]      = "[INFO]",
+    [Severity::Debug]     = "[DEBUG]",
+    [Severity::Warning]   = "[WARNING]",
+    [Severity::Failed]    = "[FAILURE]",
+    [Severity::Error]     = "[ERROR]",
+    [Severity::Signal]    = "[SIGNAL]",
+    [Severity::Exception] = "[THROW]",
+    [Severity::Catch]     = "[CATCH]",
+    [Severity::Fatal]     = "[FATAL]"
+};
+#pragma GCC diagnostic pop
+
+std::atomic<int> ILogger::s_threshold{int(None)};
+std::atomic<int> ILogger::s_recorded{int(MaxLoggerSeverity) + 1};
+std::atomic<int> ILogger::s_enabled{int(None)};
+
+//! \brief Scratch buffer of the calling thread for ILogger::strtime().
+static thread_local char t_buffer_time[32];
+
+//------------------------------------------------------------------------------
+//! \brief Format the message after the first n chars of the line. When it does
+//! not fit, the line moves into a chunk large enough and the message is
+//! formatted again. Room is kept for the final "\n\0" (see endOfLine()).
+//! \return the length of the line.
+//------------------------------------------------------------------------------
+static size_t vformat(LineBuffer& line, size_t n, const char* format, va_list params)
+{
+    va_list retry;
+    va_copy(retry, params);
+    int res = vsnprintf(line.data() + n, line.size() - 2u - n, format, params);
+
+    // vsnprintf returns the untruncated length.
+    if ((res > 0) && (n + size_t(res) + 3u > line.size()) &&
+        line.reserve(n + size_t(res) + 3u, n))
+    {
+        res = vsnprintf(line.data() + n, line.size() - 2u - n, format, retry);
+    }
+    va_end(retry);
+
+    // Out of memory: the message is truncated.
+    if (res > 0)
+    {
+        if (n + size_t(res) + 3u > line.size())
+        {
+            Metrics::truncated();
+        }
+        n += std::min(size_t(res), line.size() - 3u - n);
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Thread-safe localtime().
+//------------------------------------------------------------------------------
+static void localTime(struct tm& tm, time_t const when = time(nullptr))
+{
+#if defined(_WIN32)
+    localtime_s(&tm, &when);
+#else
+    localtime_r(&when, &tm);
+#endif
+}
+
+//------------------------------------------------------------------------------
+const char *ILogger::severityName(enum Severity const severity)
+{
+    return c_str_severity[severity];
+}
+
+//------------------------------------------------------------------------------
+//! \brief Compare length chars ignoring their case.
+//------------------------------------------------------------------------------
+static bool sameText(const char* a, const char* b, size_t const length)
+{
+    for (size_t i = 0u; i < length; ++i)
+    {
+        if (std::toupper(uint8_t(a[i])) != std::toupper(uint8_t(b[i])))
+            return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool ILogger::severity(const char* name, enum Severity& severity)
+{
+    size_t const size = strlen(name);
+    for (int i = Info; i <= MaxLoggerSeverity; ++i)
+    {
+        // "[INFO]" with or without its brackets.
+        const char* tag = c_str_severity[i];
+        size_t const length = strlen(tag);
+        if (((size == length) && sameText(name, tag, length)) ||
+            ((size + 2u == length) && sameText(name, tag + 1, size)))
+        {
+            severity = Severity(i);
+            return true;
+        }
+    }
+    return false;
+}
+
 //------------------------------------------------------------------------------
 const char *ILogger::strtime()
 {
-    currentTime();
-    return m_buffer_time;
+    Clock::format(t_buffer_time, sizeof (t_buffer_time), Clock::now());
+    return t_buffer_time;
 }
 
 //------------------------------------------------------------------------------
-void ILogger::currentDate()
+void ILogger::currentDate(char* buffer, size_t const size)
 {
-    time_t current_time = time(nullptr);
+    struct tm tm;
 
-    strftime(m_buffer_time, sizeof (m_buffer_time), "[%Y/%m/%d]", localtime(&current_time));
+    localTime(tm);
+    strftime(buffer, size, "[%Y/%m/%d]", &tm);
 }
 
 //------------------------------------------------------------------------------
-void ILogger::currentTime()
+void ILogger::currentTime(char* buffer, size_t const size, time_t const when)
 {
-    time_t current_time = time(nullptr);
+    struct tm tm;
 
-    strftime(m_buffer_time, sizeof (m_buffer_time), "[%H:%M:%S]", localtime(&current_time));
+    localTime(tm, when);
+    strftime(buffer, size, "[%H:%M:%S]", &tm);
 }
 
 //------------------------------------------------------------------------------
-void ILogger::log(std::ostream *stream, enum Severity severity, const char* format, ...)
+size_t ILogger::endOfLine(char* buffer, size_t length)
+{
+    if ((length == 0u) || ('\n' != buffer[length - 1u]))
+    {
+        buffer[length++] = '\n';
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+//------------------------------------------------------------------------------
+void ILogger::dispatch(std::ostream *stream, enum Severity const /*severity*/,
+                       const char *line, size_t const length, size_t const /*prefix*/)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    int n;
+    m_stream = stream;
+    write(line, int(length));
+    m_stream = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void ILogger::commit(std::ostream *stream, enum Severity const severity,
+                     const char *line, size_t const length, size_t const prefix)
+{
+    if (FlightRecorder::recording(severity))
+    {
+        FlightRecorder::record(line, length, severity);
+    }
+    if (written(severity))
+    {
+        Metrics::line(severity, length);
+        dispatch(stream, severity, line, length, prefix);
+    }
+    if ((severity == Fatal) || (severity == Signal))
+    {
+        FlightRecorder::dump();
+    }
+}
+
+//------------------------------------------------------------------------------
+void ILogger::dispatchEncoded(std::ostream *stream, const char *record, size_t const length)
+{
+    char line[c_buffer_size];
+    size_t start;
+    size_t const n = formatEncoded(line, record, length, start);
+
+    dispatch(stream, Sites::get(deferred::header(record).site).severity, line, n, start);
+}
+
+//------------------------------------------------------------------------------
+size_t ILogger::formatEncoded(char* buffer, const char *record, size_t const length,
+                              size_t& start)
+{
+    deferred::Header const header = deferred::header(record);
+    Site const& site = Sites::get(header.site);
+
+    start = prefix(buffer, c_buffer_size - 2u, site, header.time);
+    size_t const n = start + deferred::format(buffer + start, c_buffer_size - 2u - start,
+                                              site.format, record, length);
+    return endOfLine(buffer, n);
+}
+
+//------------------------------------------------------------------------------
+size_t ILogger::prefix(char* buffer, size_t const size, Site const& site, Timestamp const& when)
+{
+    return m_layout.format(buffer, size, { site.severity, &site, when });
+}
+
+//------------------------------------------------------------------------------
+char* ILogger::threadBuffer()
+{
+    static thread_local char buffer[c_buffer_size];
+    return buffer;
+}
+
+//------------------------------------------------------------------------------
+void ILogger::log(std::ostream *stream, enum Severity severity, const char* format, ...)
+{
+    Metrics::Probe const probe;
+    LineBuffer line(threadBuffer(), c_buffer_size);
+    char* buffer = line.data();
     va_list params;
 
-    m_severity = severity;
-    m_stream = stream;
-    beginOfLine();
+    // Build the whole line (prefix + message + '\n') inside the buffer of the
+    // calling thread (or a chunk for long lines) so it can be handed to the
+    // media at once.
+    Timestamp const now = Clock::now();
+    size_t n = Sequence::stamp(buffer, c_buffer_size - 2u, now);
+    n += m_layout.format(buffer + n, c_buffer_size - 2u - n, { severity, nullptr, now });
+    size_t const start = n;
     va_start(params, format);
-    n = vsnprintf(m_buffer, c_buffer_size - 2u, format, params);
+    n = vformat(line, n, format, params);
     va_end(params);
+    buffer = line.data();
+    n = endOfLine(buffer, n);
 
-    // Add a '\n' if missing
-    if ('\n' != m_buffer[n - 1])
+    // Not filtered by the threshold, but kept by the flight recorder too.
+    if (FlightRecorder::recording(severity))
+    {
+        FlightRecorder::record(buffer, n, severity);
+    }
+    Metrics::line(severity, n);
+    dispatch(stream, severity, buffer, n, start);
+    if ((severity == Fatal) || (severity == Signal))
     {
-        m_buffer[n] = '\n';
-        m_buffer[n + 1] = '\0';
+        FlightRecorder::dump();
     }
+}
 
-    write(m_buffer);
+//------------------------------------------------------------------------------
+void ILogger::log(std::ostream *stream, uint32_t const site, ...)
+{
+    va_list params;
 
-    m_stream = nullptr;
+    va_start(params, site);
+    vlog(stream, site, nullptr, params);
+    va_end(params);
 }
 
 //------------------------------------------------------------------------------
-void ILogger::log(const char* format, ...)
+void ILogger::logUnique(Repeats& repeats, std::ostream *stream, uint32_t const site, ...)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    va_list params;
+
+    va_start(params, site);
+    vlog(stream, site, &repeats, params);
+    va_end(params);
+}
 
+//------------------------------------------------------------------------------
+void ILogger::suppressed(std::ostream *stream, uint32_t const site, uint64_t const count)
+{
+    summary(stream, Sites::get(site), "%llu similar lines suppressed", count);
+}
+
+//------------------------------------------------------------------------------
+void ILogger::summary(std::ostream *stream, Site const& site, const char* format,
+                      uint64_t const count)
+{
+    char buffer[c_buffer_size];
+    Timestamp const now = Clock::now();
+
+    size_t n = Sequence::stamp(buffer, c_buffer_size - 2u, now);
+    n += prefix(buffer + n, c_buffer_size - 2u - n, site, now);
+    size_t const start = n;
+    int res = snprintf(buffer + n, c_buffer_size - 2u - n, format,
+                       static_cast<unsigned long long>(count));
+    if (res > 0)
+    {
+        n += std::min(size_t(res), c_buffer_size - 3u - n);
+    }
+    commit(stream, site.severity, buffer, endOfLine(buffer, n), start);
+}
+
+//------------------------------------------------------------------------------
+void ILogger::vlog(std::ostream *stream, uint32_t const site, Repeats* repeats,
+                   va_list params)
+{
+    Metrics::Probe const probe;
+    char* buffer = threadBuffer();
+    Site const& s = Sites::get(site);
+    uint64_t repeated = 0u;
+
+    // Binary media: only store the raw values of the arguments.
+    if (m_encoded.load(std::memory_order_relaxed))
+    {
+        deferred::Header const header = { site, Clock::now() };
+        size_t const length = deferred::vencode(buffer, c_buffer_size, header, s.format, params);
+
+        // Identical arguments give identical messages.
+        if ((repeats != nullptr) &&
+            repeats->same(Repeats::hash(buffer + sizeof (header), length - sizeof (header)),
+                          repeated))
+            return ;
+        if (repeated != 0u)
+        {
+            summary(stream, s, "last message repeated %llu times", repeated);
+        }
+
+        // The flight recorder only keeps formatted lines.
+        if (FlightRecorder::recording(s.severity))
+        {
+            char line[c_buffer_size];
+            size_t start;
+            FlightRecorder::record(line, formatEncoded(line, buffer, length, start),
+                                   s.severity);
+        }
+        if (written(s.severity))
+        {
+            Metrics::line(s.severity, length);
+            dispatchEncoded(stream, buffer, length);
+        }
+        if ((s.severity == Fatal) || (s.severity == Signal))
+        {
+            FlightRecorder::dump();
+        }
+        return ;
+    }
+
+    LineBuffer line(buffer, c_buffer_size);
+    Timestamp const now = Clock::now();
+    size_t n = Sequence::stamp(buffer, c_buffer_size - 2u, now);
+    n += prefix(buffer + n, c_buffer_size - 2u - n, s, now);
+    size_t const start = n;
+    n = vformat(line, n, s.format, params);
+
+    if ((repeats != nullptr) &&
+        repeats->same(Repeats::hash(line.data() + start, n - start), repeated))
+        return ;
+    if (repeated != 0u)
+    {
+        summary(stream, s, "last message repeated %llu times", repeated);
+    }
+
+    commit(stream, s.severity, line.data(), endOfLine(line.data(), n), start);
+}
+
+//------------------------------------------------------------------------------
+void ILogger::log(const char* format, ...)
+{
+    char buffer[c_buffer_size];
+    LineBuffer line(buffer, c_buffer_size);
     va_list params;
 
     va_start(params, format);
-    vsnprintf(m_buffer, c_buffer_size, format, params);
+    size_t const n = vformat(line, 0u, format, params);
     va_end(params);
-    write(m_buffer);
+
+    if (n > 0u)
+    {
+        Metrics::line(None, n);
+        dispatch(nullptr, None, line.data(), n, 0u);
+    }
 }
 
 } // namespace mylogger
@@ -0,0 +1,218 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "MyLogger/Layout.hpp"
+#include "MyLogger/ILogger.hpp"
+#include "MyLogger/Sequence.hpp"
+#include "MyLogger/Site.hpp"
+#include "Decimal.hpp"
+
+namespace mylogger {
+
+//! \brief Pattern of the default layout.
+static const char* c_default_pattern = "%t%S%F";
+
+//------------------------------------------------------------------------------
+//! \brief Write an unsigned integer in decimal.
+//! \return the number of chars written.
+//------------------------------------------------------------------------------
+static size_t number(char* buffer, size_t const size, uint32_t const value)
+{
+    char text[c_decimal_size];
+    return layout::copy(buffer, size, text, decimal(text, value));
+}
+
+//------------------------------------------------------------------------------
+//! \brief Write the fraction of the second with the given number of digits.
+//------------------------------------------------------------------------------
+static size_t fraction(char* buffer, size_t const size, Timestamp const& when,
+                       size_t const count, uint32_t const divisor)
+{
+    char text[9];
+    Clock::digits(text, uint32_t(Clock::nanoseconds(when) % 1000000000u) / divisor, count);
+    return layout::copy(buffer, size, text, count);
+}
+
+namespace layout {
+
+//------------------------------------------------------------------------------
+size_t Time::append(char* buffer, size_t const size, Context const& context)
+{
+    char text[32];
+    return copy(buffer, size, text, Clock::format(text, sizeof (text), context.when));
+}
+
+//------------------------------------------------------------------------------
+size_t Hms::append(char* buffer, size_t const size, Context const& context)
+{
+    return copy(buffer, size, Clock::local(Clock::seconds(context.when)).hms,
+                sizeof (LocalTime::hms));
+}
+
+//------------------------------------------------------------------------------
+size_t Date::append(char* buffer, size_t const size, Context const& context)
+{
+    return copy(buffer, size, Clock::local(Clock::seconds(context.when)).date,
+                sizeof (LocalTime::date));
+}
+
+//------------------------------------------------------------------------------
+size_t Millis::append(char* buffer, size_t const size, Context const& context)
+{
+    return fraction(buffer, size, context.when, 3u, 1000000u);
+}
+
+//------------------------------------------------------------------------------
+size_t Micros::append(char* buffer, size_t const size, Context const& context)
+{
+    return fraction(buffer, size, context.when, 6u, 1000u);
+}
+
+//------------------------------------------------------------------------------
+size_t Nanos::append(char* buffer, size_t const size, Context const& context)
+{
+    return fraction(buffer, size, context.when, 9u, 1u);
+}
+
+//------------------------------------------------------------------------------
+size_t Tag::append(char* buffer, size_t const size, Context const& context)
+{
+    const char* name = ILogger::severityName(context.severity);
+    return copy(buffer, size, name, strlen(name));
+}
+
+//------------------------------------------------------------------------------
+size_t Level::append(char* buffer, size_t const size, Context const& context)
+{
+    // "[INFO]" without its brackets.
+    const char* name = ILogger::severityName(context.severity);
+    size_t const length = strlen(name);
+    return (length < 2u) ? 0u : copy(buffer, size, name + 1, length - 2u);
+}
+
+//------------------------------------------------------------------------------
+size_t Location::append(char* buffer, size_t const size, Context const& context)
+{
+    if (context.site == nullptr)
+        return 0u;
+    return copy(buffer, size, context.site->location.data(), context.site->location.size());
+}
+
+//------------------------------------------------------------------------------
+size_t Filename::append(char* buffer, size_t const size, Context const& context)
+{
+    if ((context.site == nullptr) || (context.site->file == nullptr))
+        return 0u;
+    return copy(buffer, size, context.site->file, strlen(context.site->file));
+}
+
+//------------------------------------------------------------------------------
+size_t Line::append(char* buffer, size_t const size, Context const& context)
+{
+    if ((context.site == nullptr) || (context.site->file == nullptr))
+        return 0u;
+
+    return number(buffer, size, uint32_t(context.site->line));
+}
+
+//------------------------------------------------------------------------------
+size_t Thread::append(char* buffer, size_t const size, Context const& /*context*/)
+{
+    return number(buffer, size, Sequence::thread());
+}
+
+} // namespace layout
+
+//------------------------------------------------------------------------------
+Layout::Layout()
+{
+    compile(c_default_pattern);
+}
+
+//------------------------------------------------------------------------------
+Layout::Layout(const char* pattern)
+{
+    if (!compile(pattern))
+    {
+        compile(c_default_pattern);
+    }
+}
+
+//------------------------------------------------------------------------------
+size_t Layout::literal(char* buffer, size_t const size, layout::Context const& /*context*/,
+                       const char* text, size_t const length)
+{
+    return layout::copy(buffer, size, text, length);
+}
+
+//------------------------------------------------------------------------------
+bool Layout::compile(const char* pattern)
+{
+    std::vector<Step> steps;
+    std::string text;
+
+    // Consecutive chars of constant text make a single step.
+    auto constant = [&](char const c)
+    {
+        if (steps.empty() || (steps.back().append != &literal))
+        {
+            steps.push_back(Step{ &literal, text.size(), 0u });
+        }
+        text += c;
+        ++steps.back().length;
+    };
+
+    for (const char* p = pattern; *p != '\0'; ++p)
+    {
+        if (*p != '%')
+        {
+            constant(*p);
+            continue;
+        }
+
+        Appender append = nullptr;
+        switch (*++p)
+        {
+        case '%': constant('%'); continue;
+        case 'm': if (p[1] != '\0') return false; continue;
+        case 't': append = &field<layout::Time>; break;
+        case 'T': append = &field<layout::Hms>; break;
+        case 'D': append = &field<layout::Date>; break;
+        case 'e': append = &field<layout::Millis>; break;
+        case 'u': append = &field<layout::Micros>; break;
+        case 'n': append = &field<layout::Nanos>; break;
+        case 'S': append = &field<layout::Tag>; break;
+        case 'L': append = &field<layout::Level>; break;
+        case 'F': append = &field<layout::Location>; break;
+        case 'f': append = &field<layout::Filename>; break;
+        case 'l': append = &field<layout::Line>; break;
+        case 'i': append = &field<layout::Thread>; break;
+        default: return false; // Including the final '\0'
+        }
+        steps.push_back(Step{ append, 0u, 0u });
+    }
+
+    m_steps.swap(steps);
+    m_text.swap(text);
+    return true;
+}
+
+} // namespace mylogger
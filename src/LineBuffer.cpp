@@ -0,0 +1,111 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/LineBuffer.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace mylogger {
+
+char* ChunkPool::s_free[ChunkPool::c_classes] = { nullptr };
+std::atomic<size_t> ChunkPool::s_cached{0u};
+std::atomic<uint64_t> ChunkPool::s_allocations{0u};
+
+//! \brief Serialize the free lists. Only taken by lines longer than
+//! ILogger::c_buffer_size, whose copy costs much more.
+static std::mutex s_mutex;
+
+//------------------------------------------------------------------------------
+//! \brief Return the index of the smallest power of two holding size bytes.
+//------------------------------------------------------------------------------
+static size_t sizeClass(size_t const size)
+{
+    size_t index = 0u;
+    while ((size_t(1) << index) < size)
+    {
+        ++index;
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+char* ChunkPool::acquire(size_t const size, size_t& capacity)
+{
+    size_t const index = sizeClass((size < c_min_chunk) ? c_min_chunk : size);
+    if (index >= c_classes)
+        return nullptr;
+    capacity = size_t(1) << index;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        char* chunk = s_free[index];
+        if (chunk != nullptr)
+        {
+            memcpy(&s_free[index], chunk, sizeof (char*));
+            s_cached.fetch_sub(capacity, std::memory_order_relaxed);
+            return chunk;
+        }
+    }
+
+    s_allocations.fetch_add(1u, std::memory_order_relaxed);
+    return static_cast<char*>(malloc(capacity));
+}
+
+//------------------------------------------------------------------------------
+void ChunkPool::release(char* chunk, size_t const capacity)
+{
+    if (chunk == nullptr)
+        return ;
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_cached.load(std::memory_order_relaxed) + capacity <= c_max_cached)
+        {
+            size_t const index = sizeClass(capacity);
+            memcpy(chunk, &s_free[index], sizeof (char*));
+            s_free[index] = chunk;
+            s_cached.fetch_add(capacity, std::memory_order_relaxed);
+            return ;
+        }
+    }
+
+    free(chunk);
+}
+
+//------------------------------------------------------------------------------
+bool LineBuffer::grow(size_t const size, size_t const used)
+{
+    size_t capacity;
+    char* chunk = ChunkPool::acquire(size, capacity);
+    if (chunk == nullptr)
+        return false;
+
+    memcpy(chunk, m_data, used);
+    if (m_data != m_inline)
+    {
+        ChunkPool::release(m_data, m_size);
+    }
+    m_data = chunk;
+    m_size = capacity;
+    return true;
+}
+
+} // namespace mylogger
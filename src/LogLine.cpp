@@ -0,0 +1,90 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/LogLine.hpp"
+#include "MyLogger/Site.hpp"
+#include "MyLogger/Sequence.hpp"
+#include "Decimal.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+LogLine::LogLine(ILogger& logger, std::ostream *stream, uint32_t const site)
+    : m_logger(logger), m_stream(stream), m_line(m_buffer, sizeof (m_buffer))
+{
+    Site const& s = Sites::get(site);
+    m_severity = s.severity;
+    Timestamp const now = Clock::now();
+    m_length = Sequence::stamp(m_buffer, ILogger::c_buffer_size - 2u, now);
+    m_length += m_logger.prefix(m_buffer + m_length, ILogger::c_buffer_size - 2u - m_length,
+                                s, now);
+    m_prefix = m_length;
+}
+
+//------------------------------------------------------------------------------
+LogLine::~LogLine()
+{
+    if (m_truncated)
+    {
+        Metrics::truncated();
+    }
+    m_logger.commit(m_stream, m_severity, m_line.data(),
+                    ILogger::endOfLine(m_line.data(), m_length), m_prefix);
+}
+
+//------------------------------------------------------------------------------
+LogLine& LogLine::append(const char* data, size_t const length)
+{
+    // Keep room for the final "\n\0" (see ILogger::endOfLine()). Out of
+    // memory: the line is truncated.
+    m_line.reserve(m_length + length + 2u, m_length);
+    size_t const n = std::min(length, m_line.size() - 2u - m_length);
+    memcpy(m_line.data() + m_length, data, n);
+    m_length += n;
+    m_truncated |= (n < length);
+    return *this;
+}
+
+//------------------------------------------------------------------------------
+LogLine& LogLine::integer(uint64_t value, bool const negative)
+{
+    char text[c_decimal_size];
+    return append(text, decimal(text, value, negative));
+}
+
+//------------------------------------------------------------------------------
+LogLine& LogLine::real(double const value)
+{
+    char text[32];
+    int n = snprintf(text, sizeof (text), "%g", value);
+    return append(text, (n < 0) ? 0u : std::min(size_t(n), sizeof (text) - 1u));
+}
+
+//------------------------------------------------------------------------------
+LogLine& LogLine::operator<<(const void* pointer)
+{
+    char text[32];
+    int n = snprintf(text, sizeof (text), "%p", pointer);
+    return append(text, (n < 0) ? 0u : std::min(size_t(n), sizeof (text) - 1u));
+}
+
+} // namespace mylogger
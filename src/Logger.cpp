@@ -20,44 +20,34 @@
 
 #include "MyLogger/Logger.hpp"
 #include "MyLogger/File.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 namespace mylogger {
 
-//------------------------------------------------------------------------------
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wpedantic"
-static const char *c_str_severity[Severity::MaxLoggerSeverity + 1] =
-{
-    [Severity::None]      = "",
-    [Severity::Info]      = "[INFO]",
-    [Severity::Debug]     = "[DEBUG]",
-    [Severity::Warning]   = "[WARNING]",
-    [Severity::Failed]    = "[FAILURE]",
-    [Severity::Error]     = "[ERROR]",
-    [Severity::Signal]    = "[SIGNAL]",
-    [Severity::Exception] = "[THROW]",
-    [Severity::Catch]     = "[CATCH]",
-    [Severity::Fatal]     = "[FATAL]"
-};
-#pragma GCC diagnostic pop
-
 //------------------------------------------------------------------------------
 Logger::Logger(project::Info const& info)
     : m_info(info)
 {
+    std::lock_guard<std::mutex> lock(m_reconfig);
     open(m_info.log_path);
 }
 
 //------------------------------------------------------------------------------
 Logger::~Logger()
 {
-    close();
+    {
+        std::lock_guard<std::mutex> lock(m_reconfig);
+        close();
+    }
+    stopAsync();
 }
 
 //------------------------------------------------------------------------------
 bool Logger::changeLog(project::Info const& info)
 {
-    close();
+    std::lock_guard<std::mutex> lock(m_reconfig);
     m_info = info;
     return open(m_info.log_path);
 }
@@ -65,7 +55,7 @@ bool Logger::changeLog(project::Info const& info)
 //------------------------------------------------------------------------------
 bool Logger::changeLog(std::string const& logpath)
 {
-    close();
+    std::lock_guard<std::mutex> lock(m_reconfig);
     m_info.log_path = logpath;
     m_info.log_name = File::fileName(logpath);
     if (m_info.log_name.empty())
@@ -78,109 +68,549 @@ bool Logger::changeLog(std::string const& logpath)
 //------------------------------------------------------------------------------
 bool Logger::open(std::string const& logfile)
 {
-    // Distinguish behavior between simple file and absolute path.
-    std::string dir = File::dirName(logfile);
-    std::string file(logfile);
-    if (dir.empty())
-    {
-        dir = m_info.tmp_path;
-        file = dir + file;
-    }
-
-    // Call it before Logger constructor
-    if (!File::mkdir(dir))
-    {
-        std::cerr << "Failed creating the temporary directory '"
-                  << m_info.tmp_path << "'" << std::endl;
+    Target* next = prepare(logfile);
+    if (next == nullptr)
         return false;
-    }
+
+    publish(next);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void Logger::close()
+{
+    publish(nullptr);
+}
+
+//------------------------------------------------------------------------------
+Logger::Target* Logger::prepare(std::string const& logfile)
+{
+    std::string file;
+    if (!logPath(logfile, m_info, file))
+        return nullptr;
+
+    // Pending rotations still move files to their log path.
+    m_archiver.wait();
+
+    std::unique_ptr<Target> target(new Target);
+    target->info = m_info;
+    target->path = file;
+    target->file.policy(filePolicy());
 
     // Try to open the given log path
-    m_file.open(file.c_str());
-    if (!m_file)
+    if (!target->file.open(file))
     {
         std::cerr << "Failed creating the log file '"
                   << file << "'. Reason is '"
                   << strerror(errno) << "'"
                   << std::endl;
-        return false;
+        return nullptr;
     }
-    else
+
+    std::cout << "Log created: '" << file
+              << "'" << std::endl << std::endl;
+    target->encoded = (m_format == FileFormat::Binary);
+    if (target->encoded)
     {
-        std::cout << "Log created: '" << file
-                  << "'" << std::endl << std::endl;
+        target->binary.start(target->file);
+    }
+
+    char banner[c_buffer_size];
+    store(*target, banner, formatHeader(banner, sizeof (banner), target->info), None);
+    return target.release();
+}
+
+//------------------------------------------------------------------------------
+void Logger::publish(Target* next)
+{
+    // Lines logged so far end in the previous file, before its footer.
+    drain();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        footer();
+    }
+
+    Target* previous = m_target.exchange(next, std::memory_order_acq_rel);
+    m_encoded.store((next != nullptr) && next->encoded, std::memory_order_relaxed);
+
+    // The file is only used while holding m_mutex: once we got it, no thread
+    // uses the previous file any more.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
         header();
     }
-    return true;
+    retire(previous);
 }
 
 //------------------------------------------------------------------------------
-void Logger::close()
+void Logger::retire(Target* target)
 {
-    if (!m_file)
+    if (target == nullptr)
         return ;
 
-    footer();
-    m_file.close();
+    char banner[c_buffer_size];
+    store(*target, banner, formatFooter(banner, sizeof (banner), target->info), None);
+    target->file.close();
+    delete target;
+}
+
+//------------------------------------------------------------------------------
+void Logger::flushPolicy(FlushPolicy const& policy)
+{
+    std::lock_guard<std::mutex> reconfig(m_reconfig);
+    m_flush = policy;
+    m_flush_set = true;
+
+    // The current file is only used under m_mutex.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Target* target = m_target.load(std::memory_order_acquire);
+    if (target != nullptr)
+    {
+        target->file.policy(policy);
+    }
+}
+
+//------------------------------------------------------------------------------
+FlushPolicy Logger::filePolicy() const
+{
+    if (m_flush_set || (m_queue != nullptr))
+        return m_flush;
+
+    FlushPolicy policy;
+    policy.bytes = 0u;
+    return policy;
 }
 
 //------------------------------------------------------------------------------
-void Logger::write(const char *message, const int /*length*/)
+void Logger::rotationPolicy(RotationPolicy const& policy)
 {
-    if (nullptr != m_stream)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_archiver.policy(policy);
+}
+
+//------------------------------------------------------------------------------
+void Logger::addSink(std::shared_ptr<ISink> const& sink)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sinks.push_back(sink);
+}
+
+//------------------------------------------------------------------------------
+void Logger::removeSink(std::shared_ptr<ISink> const& sink)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sinks.erase(std::remove(m_sinks.begin(), m_sinks.end(), sink), m_sinks.end());
+}
+
+//------------------------------------------------------------------------------
+void Logger::consoleColors(ColorMode const mode)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stdout.colors(mode);
+    m_stderr.colors(mode);
+}
+
+//------------------------------------------------------------------------------
+void Logger::write(const char *message, const int length)
+{
+    size_t const size = (length < 0) ? strlen(message) : size_t(length);
+
+    // Same path than the LOG* macros: the file is only used under m_mutex.
+    dispatch(m_stream, None, message, size, 0u);
+}
+
+//------------------------------------------------------------------------------
+void Logger::dispatch(std::ostream *stream, enum Severity const severity,
+                      const char *line, size_t const length, size_t const prefix)
+{
+    // The queue is lock-free: no need to serialize producers.
+    if (m_queue != nullptr)
     {
-        (*m_stream) << message;
-        m_stream->flush();
+        enqueue(stream, severity, line, length, prefix);
+        return ;
     }
 
-    if (!m_file)
+    auto const lock = acquire();
+    output(stream, severity, line, length, prefix);
+}
+
+//------------------------------------------------------------------------------
+void Logger::dispatchEncoded(std::ostream *stream, const char *record, size_t const length)
+{
+    if (m_queue != nullptr)
+    {
+        push([stream, record, length](Record& r)
+        {
+            r.stream = stream;
+            r.deferred = true;
+            r.chunk = nullptr;
+            r.length = uint32_t(std::min(length, size_t(c_buffer_size)));
+            memcpy(r.data, record, r.length);
+        });
         return ;
+    }
 
-    m_file << message;
-    m_file.flush();
+    auto const lock = acquire();
+    outputEncoded(stream, record, length);
 }
 
 //------------------------------------------------------------------------------
-void Logger::beginOfLine()
+std::unique_lock<std::mutex> Logger::acquire()
 {
-    currentTime();
-    write(m_buffer_time);
-    write(c_str_severity[m_severity]);
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+
+    // Only read the clock when the mutex is contended.
+    if (!lock.owns_lock())
+    {
+        uint64_t const start = Metrics::now();
+        lock.lock();
+        Metrics::mutexWait(Metrics::now() - start);
+    }
+    return lock;
+}
+
+//------------------------------------------------------------------------------
+void Logger::output(std::ostream *stream, enum Severity const severity,
+                    const char *line, size_t const length, size_t const prefix)
+{
+    Target* target = m_target.load(std::memory_order_acquire);
+    if (target != nullptr)
+    {
+        store(*target, line, length, severity);
+    }
+    broadcast(stream, severity, line, length, prefix);
+
+    if ((target != nullptr) && m_archiver.enabled() && m_archiver.due(target->file.size()))
+    {
+        rotate(*target);
+    }
+    if ((target != nullptr) && (m_stats_period.load(std::memory_order_relaxed) != 0))
+    {
+        dumpStats(*target);
+    }
+}
+
+//------------------------------------------------------------------------------
+void Logger::outputEncoded(std::ostream *stream, const char *record, size_t const length)
+{
+    char line[c_buffer_size];
+    size_t start;
+
+    Target* target = m_target.load(std::memory_order_acquire);
+    if ((target == nullptr) || !target->encoded)
+    {
+        size_t const n = formatEncoded(line, record, length, start);
+        output(stream, Sites::get(deferred::header(record).site).severity, line, n, start);
+        return ;
+    }
+
+    target->binary.statement(target->file, record, length);
+    if ((nullptr != stream) || !m_sinks.empty())
+    {
+        size_t const n = formatEncoded(line, record, length, start);
+        broadcast(stream, Sites::get(deferred::header(record).site).severity, line, n, start);
+    }
+
+    if (m_archiver.enabled() && m_archiver.due(target->file.size()))
+    {
+        rotate(*target);
+    }
+    if (m_stats_period.load(std::memory_order_relaxed) != 0)
+    {
+        dumpStats(*target);
+    }
+}
+
+//------------------------------------------------------------------------------
+void Logger::broadcast(std::ostream *stream, enum Severity const severity,
+                       const char *line, size_t const length, size_t const prefix)
+{
+    Console* console = (stream == &std::cout) ? &m_stdout :
+                       (stream == &std::cerr) ? &m_stderr : nullptr;
+    if (nullptr != console)
+    {
+        // The writer thread batches the lines until the queue is empty.
+        if (m_queue != nullptr)
+        {
+            console->append(severity, line, length);
+        }
+        else
+        {
+            // Keep the order with what the application printed.
+            if (console == &m_stdout)
+            {
+                fflush(stdout);
+            }
+            console->write(severity, line, length);
+        }
+    }
+    else if (nullptr != stream)
+    {
+        stream->write(line, std::streamsize(length));
+        stream->flush();
+    }
+
+    if (!m_sinks.empty())
+    {
+        LogEntry const entry = { severity, line, length, prefix };
+        for (auto const& it: m_sinks)
+        {
+            it->consume(entry);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void Logger::store(Target& target, const char *text, size_t const length,
+                   enum Severity const severity)
+{
+    if (target.encoded)
+    {
+        target.binary.text(target.file, text, length, severity);
+    }
+    else
+    {
+        target.file.write(text, length, severity);
+    }
+}
+
+//------------------------------------------------------------------------------
+Stats Logger::stats() const
+{
+    Stats stats;
+
+    Metrics::collect(stats);
+    stats.queue_depth = (m_queue != nullptr) ? m_queue->size() : 0u;
+    return stats;
+}
+
+//------------------------------------------------------------------------------
+void Logger::statsPeriod(std::chrono::milliseconds const period)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stats_last = std::chrono::steady_clock::now();
+    m_stats_period.store(int64_t(period.count()), std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void Logger::dumpStats(Target& target)
+{
+    auto const now = std::chrono::steady_clock::now();
+    if (now - m_stats_last < std::chrono::milliseconds(m_stats_period.load()))
+        return ;
+    m_stats_last = now;
+
+    char line[c_buffer_size];
+    size_t n = m_layout.format(line, sizeof (line), { Info, nullptr, Clock::now() });
+    int const res = snprintf(line + n, sizeof (line) - n, "[STATS] ");
+    n += (res < 0) ? 0u : std::min(size_t(res), sizeof (line) - 1u - n);
+    n += stats().format(line + n, sizeof (line) - 2u - n);
+    store(target, line, endOfLine(line, n), Info);
+}
+
+//------------------------------------------------------------------------------
+void Logger::rotate(Target& target)
+{
+    char banner[c_buffer_size];
+
+    store(target, banner, formatFooter(banner, sizeof (banner), target.info), None);
+    target.file.close();
+
+    // Renaming the files is left to the archiver thread.
+    std::string const incoming = m_archiver.incoming(target.path);
+    if (!target.file.open(incoming))
+    {
+        std::cerr << "Failed rotating the log file '" << target.path
+                  << "'. Reason is '" << strerror(errno) << "'"
+                  << std::endl;
+        target.file.open(target.path, true);
+    }
+    else
+    {
+        m_archiver.archive(target.path, incoming);
+        if (target.encoded)
+        {
+            target.binary.start(target.file);
+        }
+    }
+    store(target, banner, formatHeader(banner, sizeof (banner), target.info), None);
+}
+
+//------------------------------------------------------------------------------
+void Logger::startAsync(size_t const capacity, QueueFullPolicy const policy)
+{
+    std::lock_guard<std::mutex> reconfig(m_reconfig);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_queue != nullptr)
+        return ;
+
+    m_policy = policy;
+    m_queue.reset(new RingBuffer<Record>(capacity));
+    m_running = true;
+    m_writer = std::thread(&Logger::consume, this);
+
+    // The writer thread flushes the lines: they can be buffered.
+    Target* target = m_target.load(std::memory_order_acquire);
+    if (target != nullptr)
+    {
+        target->file.policy(filePolicy());
+    }
+}
+
+//------------------------------------------------------------------------------
+void Logger::stopAsync()
+{
+    if (m_queue == nullptr)
+        return ;
+
+    drain();
+    m_running = false;
+    m_wakeup.notify_one();
+    m_writer.join();
+
+    // No thread flushes the lines anymore.
+    std::lock_guard<std::mutex> reconfig(m_reconfig);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.reset();
+    Target* target = m_target.load(std::memory_order_acquire);
+    if (target != nullptr)
+    {
+        target->file.policy(filePolicy());
+    }
+}
+
+//------------------------------------------------------------------------------
+void Logger::enqueue(std::ostream *stream, enum Severity const severity,
+                     const char *message, size_t const length, size_t const prefix)
+{
+    push([stream, severity, message, length, prefix](Record& record)
+    {
+        record.stream = stream;
+        record.deferred = false;
+        record.severity = uint8_t(severity);
+        record.prefix = uint16_t(prefix);
+        record.chunk = nullptr;
+        if (length > c_buffer_size)
+        {
+            record.chunk = ChunkPool::acquire(length, record.capacity);
+        }
+        if (record.chunk != nullptr)
+        {
+            record.length = uint32_t(length);
+            memcpy(record.chunk, message, length);
+        }
+        else
+        {
+            record.length = uint32_t(std::min(length, size_t(c_buffer_size)));
+            memcpy(record.data, message, record.length);
+        }
+    });
+}
+
+//------------------------------------------------------------------------------
+void Logger::drain()
+{
+    if (m_queue == nullptr)
+        return ;
+
+    std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+    m_wakeup.notify_one();
+    while (!m_queue->empty() || m_busy.load())
+    {
+        m_drained.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+//------------------------------------------------------------------------------
+void Logger::consume()
+{
+    auto pop = [this](Record& record)
+    {
+        // Deferred formatting: the caller only stored raw arguments.
+        if (record.deferred)
+        {
+            outputEncoded(record.stream, record.data, record.length);
+        }
+        else if (record.chunk != nullptr)
+        {
+            output(record.stream, Severity(record.severity), record.chunk, record.length,
+                   record.prefix);
+            ChunkPool::release(record.chunk, record.capacity);
+        }
+        else
+        {
+            output(record.stream, Severity(record.severity), record.data, record.length,
+                   record.prefix);
+        }
+    };
+
+    for (;;)
+    {
+        // Write everything available. The mutex is only shared with the
+        // methods opening or closing the file.
+        m_busy = true;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (m_queue->pop(pop))
+                ;
+            Target* target = m_target.load(std::memory_order_acquire);
+            if (target != nullptr)
+            {
+                if (m_stats_period.load(std::memory_order_relaxed) != 0)
+                {
+                    dumpStats(*target);
+                }
+                target->file.flushIfExpired();
+            }
+            for (auto const& it: m_sinks)
+            {
+                it->idle();
+            }
+            m_stdout.flush();
+            m_stderr.flush();
+        }
+        m_busy = false;
+        m_drained.notify_all();
+
+        std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+        if (!m_running && m_queue->empty())
+            return ;
+        if (m_queue->empty())
+        {
+            m_wakeup.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
 void Logger::header()
 {
-    currentDate();
-    log("======================================================\n"
-        "  %s %s %u.%u - Event log - %s\n"
-        "  git branch: %s\n"
-        "  git SHA1: %s\n"
-        "======================================================\n\n",
-        m_info.project_name.c_str(),
-        m_info.debug ? "Debug" : "Release",
-        m_info.major_version,
-        m_info.minor_version,
-        m_buffer_time,
-        m_info.git_branch.c_str(),
-        m_info.git_sha1.c_str());
+    Target* target = m_target.load(std::memory_order_acquire);
+    if ((target == nullptr) || m_sinks.empty())
+        return ;
+
+    char banner[c_buffer_size];
+    broadcast(nullptr, None, banner, formatHeader(banner, sizeof (banner), target->info), 0u);
 }
 
 //------------------------------------------------------------------------------
 void Logger::footer()
 {
-    currentTime();
-    log("\n======================================================\n"
-        "  %s log closed at %s\n"
-        "======================================================\n\n",
-        m_info.project_name.c_str(),
-        m_buffer_time);
+    Target* target = m_target.load(std::memory_order_acquire);
+    if ((target == nullptr) || m_sinks.empty())
+        return ;
+
+    char banner[c_buffer_size];
+    broadcast(nullptr, None, banner, formatFooter(banner, sizeof (banner), target->info), 0u);
 }
 
 //------------------------------------------------------------------------------
 ILogger& Logger::operator<<(const Severity& severity)
 {
-    write(c_str_severity[severity]);
+    write(severityName(severity));
     return *this;
 }
 
@@ -0,0 +1,136 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "MyLogger/Merger.hpp"
+#include <cstring>
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+bool Merger::Entry::operator>(Entry const& other) const
+{
+    if (stamp.time != other.stamp.time)
+        return stamp.time > other.stamp.time;
+    if (stamp.thread != other.stamp.thread)
+        return stamp.thread > other.stamp.thread;
+    if (stamp.sequence != other.stamp.sequence)
+        return stamp.sequence > other.stamp.sequence;
+    if (line.input != other.line.input)
+        return line.input > other.line.input;
+    return rank > other.rank;
+}
+
+//------------------------------------------------------------------------------
+Merger::Merger(size_t const window)
+    : m_window((window == 0u) ? 1u : window)
+{}
+
+//------------------------------------------------------------------------------
+void Merger::add(const char* data, size_t const size)
+{
+    Cursor cursor;
+    cursor.data = data;
+    cursor.size = size;
+    cursor.position = 0u;
+    cursor.last = { 0u, 0u, 0u };
+    cursor.first = 0u;
+    m_cursors.push_back(cursor);
+}
+
+//------------------------------------------------------------------------------
+bool Merger::read(size_t const input)
+{
+    Cursor& cursor = m_cursors[input];
+    if (cursor.position >= cursor.size)
+        return false;
+
+    Entry entry;
+    entry.offset = cursor.position;
+    entry.rank = cursor.first + cursor.pending.size();
+    entry.line.input = input;
+    entry.line.text = cursor.data + cursor.position;
+
+    // The first line, then the following ones without stamp.
+    Stamp following;
+    const char* end = cursor.data + cursor.size;
+    const char* p = entry.line.text;
+    entry.line.stamp = Sequence::parse(p, size_t(end - p), entry.stamp);
+    if (entry.line.stamp != 0u)
+    {
+        cursor.last = entry.stamp;
+    }
+    else
+    {
+        entry.stamp = cursor.last;
+    }
+    do
+    {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', size_t(end - p)));
+        p = (eol == nullptr) ? end : eol + 1;
+    } while ((p < end) && (Sequence::parse(p, size_t(end - p), following) == 0u));
+
+    entry.line.length = size_t(p - entry.line.text);
+    cursor.position += entry.line.length;
+    cursor.pending.push_back(std::make_pair(entry.offset, false));
+    m_entries.push(entry);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool Merger::next(Line& line)
+{
+    if (!m_started)
+    {
+        m_started = true;
+        for (size_t i = 0u; i < m_cursors.size(); ++i)
+        {
+            for (size_t n = 0u; (n < m_window) && read(i); ++n)
+                ;
+        }
+    }
+
+    if (m_entries.empty())
+        return false;
+
+    Entry const entry = m_entries.top();
+    m_entries.pop();
+    line = entry.line;
+
+    // Forget the returned lines and keep the window full.
+    Cursor& cursor = m_cursors[line.input];
+    cursor.pending[size_t(entry.rank - cursor.first)].second = true;
+    while (!cursor.pending.empty() && cursor.pending.front().second)
+    {
+        cursor.pending.pop_front();
+        ++cursor.first;
+    }
+    read(line.input);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+size_t Merger::consumed(size_t const input) const
+{
+    Cursor const& cursor = m_cursors[input];
+    return cursor.pending.empty() ? cursor.position : cursor.pending.front().first;
+}
+
+} // namespace mylogger
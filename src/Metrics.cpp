@@ -0,0 +1,342 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "MyLogger/Metrics.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace mylogger {
+
+std::atomic<bool> Metrics::s_latency{false};
+constexpr size_t Histogram::c_sub_bits;
+constexpr size_t Histogram::c_sub_buckets;
+constexpr size_t Histogram::c_max_bits;
+constexpr size_t Histogram::c_buckets;
+
+//! \brief Names of the line counters in Stats::format().
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+static const char *c_line_names[MaxLoggerSeverity + 1] =
+{
+    [Severity::None]      = "lines_none",
+    [Severity::Info]      = "lines_info",
+    [Severity::Debug]     = "lines_debug",
+    [Severity::Warning]   = "lines_warning",
+    [Severity::Failed]    = "lines_failure",
+    [Severity::Error]     = "lines_error",
+    [Severity::Signal]    = "lines_signal",
+    [Severity::Exception] = "lines_throw",
+    [Severity::Catch]     = "lines_catch",
+    [Severity::Fatal]     = "lines_fatal"
+};
+#pragma GCC diagnostic pop
+
+// *****************************************************************************
+//! \brief Counters of a thread. Only the owner thread writes them, so they are
+//! updated by a relaxed load and store; atomics are only needed because
+//! collect() reads them from another thread.
+// *****************************************************************************
+struct ThreadMetrics
+{
+    typedef std::atomic<uint64_t> Counter;
+
+    Counter lines[MaxLoggerSeverity + 1] = {};
+    Counter bytes{0u};
+    Counter flushes{0u};
+    Counter truncated{0u};
+    Counter dropped{0u};
+    Counter mutex_wait{0u};
+    Counter queue_wait{0u};
+    Counter latency[Histogram::c_buckets] = {};
+
+    //! \brief Add a value to a counter owned by the calling thread.
+    static void add(Counter& counter, uint64_t const value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    //! \brief Add the counters to the given snapshot.
+    void sum(Stats& stats) const
+    {
+        for (size_t i = 0u; i <= MaxLoggerSeverity; ++i)
+        {
+            stats.lines[i] += lines[i].load(std::memory_order_relaxed);
+        }
+        stats.bytes += bytes.load(std::memory_order_relaxed);
+        stats.flushes += flushes.load(std::memory_order_relaxed);
+        stats.truncated += truncated.load(std::memory_order_relaxed);
+        stats.dropped += dropped.load(std::memory_order_relaxed);
+        stats.mutex_wait += mutex_wait.load(std::memory_order_relaxed);
+        stats.queue_wait += queue_wait.load(std::memory_order_relaxed);
+        for (size_t i = 0u; i < Histogram::c_buckets; ++i)
+        {
+            stats.latency[i] += latency[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+// *****************************************************************************
+//! \brief Counters of all the threads. Never destroyed: loggers may still log
+//! while static objects are destroyed.
+// *****************************************************************************
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadMetrics*> threads;
+    //! \brief Counters of the terminated threads.
+    Stats retired;
+};
+
+static Registry& registry()
+{
+    static Registry* registry = new Registry;
+    return *registry;
+}
+
+//! \brief Counters of the calling thread (nullptr until its first count).
+static thread_local ThreadMetrics* t_metrics = nullptr;
+//! \brief Set when the thread_local variables of the thread are destroyed.
+static thread_local bool t_exited = false;
+
+// *****************************************************************************
+//! \brief Fold the counters of a terminating thread into Registry::retired.
+// *****************************************************************************
+struct ThreadExit
+{
+    ~ThreadExit()
+    {
+        t_exited = true;
+        if (t_metrics == nullptr)
+            return ;
+
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        t_metrics->sum(r.retired);
+        for (auto it = r.threads.begin(); it != r.threads.end(); ++it)
+        {
+            if (*it == t_metrics)
+            {
+                r.threads.erase(it);
+                break;
+            }
+        }
+        delete t_metrics;
+        t_metrics = nullptr;
+    }
+};
+
+//------------------------------------------------------------------------------
+//! \brief Return the counters of the calling thread, created on first use.
+//------------------------------------------------------------------------------
+static ThreadMetrics& local()
+{
+    if (t_metrics != nullptr)
+        return *t_metrics;
+
+    // After ThreadExit has run, the counters are kept until the end of the
+    // process.
+    if (!t_exited)
+    {
+        static thread_local ThreadExit exit;
+        (void) exit;
+    }
+
+    t_metrics = new ThreadMetrics;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.threads.push_back(t_metrics);
+    return *t_metrics;
+}
+
+//------------------------------------------------------------------------------
+size_t Histogram::bucket(uint64_t const ns)
+{
+    if (ns < c_sub_buckets)
+        return size_t(ns);
+
+    size_t const msb = 63u - size_t(__builtin_clzll(ns));
+    if (msb >= c_max_bits)
+        return c_buckets - 1u;
+
+    size_t const shift = msb - c_sub_bits;
+    return (shift + 1u) * c_sub_buckets + size_t(ns >> shift) - c_sub_buckets;
+}
+
+//------------------------------------------------------------------------------
+uint64_t Histogram::highest(size_t const bucket)
+{
+    if (bucket < c_sub_buckets)
+        return uint64_t(bucket);
+
+    size_t const shift = bucket / c_sub_buckets - 1u;
+    uint64_t const sub = uint64_t(bucket % c_sub_buckets);
+    return ((c_sub_buckets + sub + 1u) << shift) - 1u;
+}
+
+//------------------------------------------------------------------------------
+uint64_t Stats::total() const
+{
+    uint64_t sum = 0u;
+    for (size_t i = 0u; i <= MaxLoggerSeverity; ++i)
+    {
+        sum += lines[i];
+    }
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+uint64_t Stats::percentile(double const ratio) const
+{
+    uint64_t count = 0u;
+    for (size_t i = 0u; i < Histogram::c_buckets; ++i)
+    {
+        count += latency[i];
+    }
+    if (count == 0u)
+        return 0u;
+
+    // Rank of the wanted sample, from 1 to count.
+    uint64_t rank = uint64_t(ratio * double(count) + 0.5);
+    rank = (rank < 1u) ? 1u : ((rank > count) ? count : rank);
+
+    uint64_t seen = 0u;
+    for (size_t i = 0u; i < Histogram::c_buckets; ++i)
+    {
+        seen += latency[i];
+        if (seen >= rank)
+            return Histogram::highest(i);
+    }
+    return Histogram::highest(Histogram::c_buckets - 1u);
+}
+
+//------------------------------------------------------------------------------
+size_t Stats::format(char* buffer, size_t const size) const
+{
+    size_t n = 0u;
+
+    auto append = [&](const char* key, uint64_t const value)
+    {
+        if (n >= size)
+            return ;
+        int const res = snprintf(buffer + n, size - n, "%s%s=%" PRIu64,
+                                 (n == 0u) ? "" : " ", key, value);
+        if (res > 0)
+        {
+            n = std::min(n + size_t(res), size - 1u);
+        }
+    };
+
+    if (size == 0u)
+        return 0u;
+    buffer[0] = '\0';
+
+    append("lines", total());
+    for (size_t i = 0u; i <= MaxLoggerSeverity; ++i)
+    {
+        if (lines[i] != 0u)
+        {
+            append(c_line_names[i], lines[i]);
+        }
+    }
+    append("bytes", bytes);
+    append("flushes", flushes);
+    append("truncated", truncated);
+    append("dropped", dropped);
+    append("mutex_wait_ns", mutex_wait);
+    append("queue_wait_ns", queue_wait);
+    append("queue_depth", queue_depth);
+    if (percentile(1.0) != 0u)
+    {
+        append("latency_p50_ns", percentile(0.50));
+        append("latency_p99_ns", percentile(0.99));
+        append("latency_p999_ns", percentile(0.999));
+        append("latency_max_ns", percentile(1.0));
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+void Metrics::latency(bool const enable)
+{
+    s_latency.store(enable, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::line(enum Severity const severity, size_t const bytes)
+{
+    ThreadMetrics& m = local();
+    ThreadMetrics::add(m.lines[severity], 1u);
+    ThreadMetrics::add(m.bytes, bytes);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::flush()
+{
+    ThreadMetrics::add(local().flushes, 1u);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::truncated()
+{
+    ThreadMetrics::add(local().truncated, 1u);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::dropped()
+{
+    ThreadMetrics::add(local().dropped, 1u);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::mutexWait(uint64_t const ns)
+{
+    ThreadMetrics::add(local().mutex_wait, ns);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::queueWait(uint64_t const ns)
+{
+    ThreadMetrics::add(local().queue_wait, ns);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::record(uint64_t const ns)
+{
+    ThreadMetrics::add(local().latency[Histogram::bucket(ns)], 1u);
+}
+
+//------------------------------------------------------------------------------
+void Metrics::collect(Stats& stats)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    stats = r.retired;
+    for (auto const& it: r.threads)
+    {
+        it->sum(stats);
+    }
+}
+
+} // namespace mylogger
@@ -0,0 +1,295 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#if !defined(_WIN32)
+
+#include "MyLogger/MmapLogger.hpp"
+#include "MyLogger/File.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace mylogger {
+
+//! \brief Index of a slot not holding any segment.
+static constexpr uint64_t c_no_segment = std::numeric_limits<uint64_t>::max();
+
+//------------------------------------------------------------------------------
+MmapLogger::MmapLogger(size_t const segment_size)
+{
+    size_t const page = size_t(sysconf(_SC_PAGESIZE));
+    m_segment_size = std::max(page, ((segment_size + page - 1u) / page) * page);
+    for (auto& it: m_segments)
+    {
+        it.index = c_no_segment;
+        it.address = nullptr;
+        it.written = 0u;
+        it.failed = false;
+    }
+}
+
+//------------------------------------------------------------------------------
+MmapLogger::MmapLogger(project::Info const& info, size_t const segment_size)
+    : MmapLogger(segment_size)
+{
+    m_info = info;
+    open(m_info.log_path);
+}
+
+//------------------------------------------------------------------------------
+MmapLogger::~MmapLogger()
+{
+    close();
+}
+
+//------------------------------------------------------------------------------
+bool MmapLogger::changeLog(project::Info const& info)
+{
+    close();
+    m_info = info;
+    return open(m_info.log_path);
+}
+
+//------------------------------------------------------------------------------
+bool MmapLogger::changeLog(std::string const& logpath)
+{
+    close();
+    m_info.log_path = logpath;
+    m_info.log_name = File::fileName(logpath);
+    if (m_info.log_name.empty())
+    {
+        m_info.log_name = "log.txt";
+    }
+    return open(m_info.log_path);
+}
+
+//------------------------------------------------------------------------------
+bool MmapLogger::open(std::string const& logfile)
+{
+    std::string file;
+    if (!logPath(logfile, m_info, file))
+        return false;
+
+    // Mapping a file needs read access
+    m_fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (m_fd < 0)
+    {
+        std::cerr << "Failed creating the log file '"
+                  << file << "'. Reason is '"
+                  << strerror(errno) << "'"
+                  << std::endl;
+        return false;
+    }
+
+    std::cout << "Log created: '" << file
+              << "'" << std::endl << std::endl;
+    m_cursor = 0u;
+    m_allocated = 0u;
+    header();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::close()
+{
+    if (m_fd < 0)
+        return ;
+
+    footer();
+
+    for (auto& it: m_segments)
+    {
+        char* address = it.address.exchange(nullptr);
+        if (address != nullptr)
+        {
+            munmap(address, m_segment_size);
+        }
+        it.failed = false;
+        it.index = c_no_segment;
+    }
+
+    // Remove the pre-allocated but unused part of the last segment.
+    if (ftruncate(m_fd, off_t(m_cursor.load())) != 0)
+    {
+        std::cerr << "Failed truncating the log file. Reason is '"
+                  << strerror(errno) << "'" << std::endl;
+    }
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::write(const char *message, const int length)
+{
+    append(message, (length < 0) ? strlen(message) : size_t(length));
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::dispatch(std::ostream *stream, enum Severity const /*severity*/,
+                          const char *line, size_t const length,
+                          size_t const /*prefix*/)
+{
+    if (nullptr != stream)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stream->write(line, std::streamsize(length));
+        stream->flush();
+    }
+
+    append(line, length);
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::append(const char *data, size_t length)
+{
+    if ((m_fd < 0) || (length == 0u))
+        return ;
+
+    uint64_t offset = m_cursor.fetch_add(length, std::memory_order_relaxed);
+
+    // A line may overlap two segments.
+    while (length > 0u)
+    {
+        uint64_t const index = offset / m_segment_size;
+        size_t const start = size_t(offset % m_segment_size);
+        size_t const n = std::min(length, m_segment_size - start);
+
+        // Bytes of a failed segment are dropped but accounted anyway.
+        char* address = segment(index);
+        if (address != nullptr)
+        {
+            memcpy(address + start, data, n);
+        }
+        release(index, n);
+
+        offset += n;
+        data += n;
+        length -= n;
+    }
+}
+
+//------------------------------------------------------------------------------
+char* MmapLogger::segment(uint64_t const index)
+{
+    Segment& slot = m_segments[index % c_max_segments];
+
+    for (;;)
+    {
+        // Fast path: the segment is already mapped.
+        if (slot.index.load(std::memory_order_acquire) == index)
+        {
+            char* address = slot.address.load(std::memory_order_acquire);
+            if (address != nullptr)
+                return address;
+            if (slot.failed.load(std::memory_order_acquire))
+                return nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (slot.index.load() == index)
+        {
+            if (slot.address.load() != nullptr)
+                return slot.address.load();
+            if (slot.failed.load())
+                return nullptr;
+        }
+
+        if ((slot.address.load() == nullptr) && !slot.failed.load())
+        {
+            // Pre-allocate the segment so that writing in the mapping
+            // cannot fail with SIGBUS for lack of disk space.
+            uint64_t const offset = index * m_segment_size;
+            uint64_t const end = offset + m_segment_size;
+            if (end > m_allocated)
+            {
+#if defined(__linux__)
+                int res = posix_fallocate(m_fd, off_t(m_allocated), off_t(end - m_allocated));
+#else
+                int res = ftruncate(m_fd, off_t(end));
+#endif
+                if (res != 0)
+                    return fail(slot, index);
+                m_allocated = end;
+            }
+
+            void* address = mmap(nullptr, m_segment_size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED, m_fd, off_t(offset));
+            if (address == MAP_FAILED)
+                return fail(slot, index);
+
+            slot.written.store(0u);
+            slot.index.store(index);
+            slot.address.store(static_cast<char*>(address), std::memory_order_release);
+            return static_cast<char*>(address);
+        }
+
+        // The slot still holds an older segment being written.
+        lock.unlock();
+        std::this_thread::yield();
+    }
+}
+
+//------------------------------------------------------------------------------
+char* MmapLogger::fail(Segment& slot, uint64_t const index)
+{
+    slot.written.store(0u);
+    slot.index.store(index);
+    slot.failed.store(true, std::memory_order_release);
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::release(uint64_t const index, size_t const bytes)
+{
+    Segment& slot = m_segments[index % c_max_segments];
+
+    // The last writer of the segment unmaps it and frees the slot.
+    if (slot.written.fetch_add(bytes, std::memory_order_acq_rel) + bytes == m_segment_size)
+    {
+        char* address = slot.address.load();
+        if (address != nullptr)
+        {
+            munmap(address, m_segment_size);
+            slot.address.store(nullptr, std::memory_order_release);
+        }
+        slot.failed.store(false, std::memory_order_release);
+    }
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::header()
+{
+    writeHeader(m_info);
+}
+
+//------------------------------------------------------------------------------
+void MmapLogger::footer()
+{
+    writeFooter(m_info);
+}
+
+} // namespace mylogger
+
+#endif // !_WIN32
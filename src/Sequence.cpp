@@ -0,0 +1,135 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "MyLogger/Sequence.hpp"
+#include "Decimal.hpp"
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <thread>
+#if defined(__linux__)
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace mylogger {
+
+static std::atomic<bool> s_enabled{false};
+
+//! \brief Identifier (0 until known) and number of lines of the calling thread.
+static thread_local uint32_t t_thread = 0u;
+static thread_local uint64_t t_sequence = 0u;
+
+//------------------------------------------------------------------------------
+//! \brief Read an unsigned integer in decimal.
+//! \return the number of chars read, 0 if there is no digit.
+//------------------------------------------------------------------------------
+static size_t decimal(const char* text, size_t const length, uint64_t& value)
+{
+    size_t n = 0u;
+
+    value = 0u;
+    while ((n < length) && (n < 20u) && (text[n] >= '0') && (text[n] <= '9'))
+    {
+        value = value * 10u + uint64_t(text[n++] - '0');
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+void Sequence::enable(bool const enable)
+{
+    s_enabled.store(enable);
+}
+
+//------------------------------------------------------------------------------
+bool Sequence::enabled()
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+uint32_t Sequence::thread()
+{
+    if (t_thread == 0u)
+    {
+#if defined(__linux__)
+        t_thread = uint32_t(syscall(SYS_gettid));
+#else
+        t_thread = uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+    }
+    return t_thread;
+}
+
+//------------------------------------------------------------------------------
+size_t Sequence::stamp(char* buffer, size_t const size, Timestamp const& when)
+{
+    if (!enabled())
+        return 0u;
+
+    // "{" time " " thread ":" sequence "}"
+    char text[64];
+    size_t n = 0u;
+    text[n++] = '{';
+    n += decimal(text + n, Clock::nanoseconds(when));
+    text[n++] = ' ';
+    n += decimal(text + n, thread());
+    text[n++] = ':';
+    n += decimal(text + n, t_sequence++);
+    text[n++] = '}';
+
+    if (n >= size)
+        return 0u;
+    memcpy(buffer, text, n);
+    buffer[n] = '\0';
+    return n;
+}
+
+//------------------------------------------------------------------------------
+size_t Sequence::parse(const char* line, size_t const length, Stamp& stamp)
+{
+    uint64_t thread;
+    size_t n = 0u, digits;
+
+    if ((length == 0u) || (line[n++] != '{'))
+        return 0u;
+    if ((digits = decimal(line + n, length - n, stamp.time)) == 0u)
+        return 0u;
+    n += digits;
+    if ((n >= length) || (line[n++] != ' '))
+        return 0u;
+    if ((digits = decimal(line + n, length - n, thread)) == 0u)
+        return 0u;
+    n += digits;
+    if ((n >= length) || (line[n++] != ':'))
+        return 0u;
+    if ((digits = decimal(line + n, length - n, stamp.sequence)) == 0u)
+        return 0u;
+    n += digits;
+    if ((n >= length) || (line[n++] != '}'))
+        return 0u;
+
+    stamp.thread = uint32_t(thread);
+    return n;
+}
+
+} // namespace mylogger
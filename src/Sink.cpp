@@ -0,0 +1,154 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Sink.hpp"
+#include "MyLogger/LineBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+void ISink::consume(LogEntry const& entry)
+{
+    if (!accepts(entry.severity))
+        return ;
+
+    size_t length;
+    const char* text = format(entry, length);
+    write(entry, text, length);
+}
+
+//------------------------------------------------------------------------------
+const char* ISink::format(LogEntry const& entry, size_t& length)
+{
+    if (!m_formatter)
+    {
+        length = entry.length;
+        return entry.line;
+    }
+
+    // Make room for the line and some decoration.
+    if (m_buffer.size() < entry.length + 1024u)
+    {
+        m_buffer.resize(std::max(size_t(4096u), entry.length + 1024u));
+    }
+    size_t const n = m_formatter(entry, m_buffer.data(), m_buffer.size());
+    length = std::min(n, m_buffer.size());
+    return m_buffer.data();
+}
+
+//------------------------------------------------------------------------------
+AsyncSink::AsyncSink(std::shared_ptr<ISink> const& sink, size_t const capacity)
+    : m_sink(sink), m_queue(capacity)
+{
+    m_thread = std::thread(&AsyncSink::run, this);
+}
+
+//------------------------------------------------------------------------------
+AsyncSink::~AsyncSink()
+{
+    m_running = false;
+    m_wakeup.notify_one();
+    m_thread.join();
+}
+
+//------------------------------------------------------------------------------
+void AsyncSink::consume(LogEntry const& entry)
+{
+    if (!accepts(entry.severity))
+        return ;
+
+    // A formatted line has no prefix: it is the message of the wrapped sink.
+    size_t length;
+    const char* text = format(entry, length);
+    size_t const prefix = (text == entry.line) ? entry.prefix : 0u;
+
+    bool const pushed = m_queue.push([&](Record& record)
+    {
+        record.severity = uint8_t(entry.severity);
+        record.chunk = nullptr;
+        if (length > c_max_line)
+        {
+            record.chunk = ChunkPool::acquire(length, record.capacity);
+        }
+        if (record.chunk != nullptr)
+        {
+            record.length = uint32_t(length);
+            memcpy(record.chunk, text, record.length);
+        }
+        else
+        {
+            record.length = uint32_t(std::min(length, size_t(c_max_line)));
+            memcpy(record.data, text, record.length);
+        }
+        record.prefix = uint16_t(std::min(prefix, size_t(record.length)));
+    });
+
+    if (!pushed)
+    {
+        m_dropped.fetch_add(1u, std::memory_order_relaxed);
+    }
+    m_wakeup.notify_one();
+}
+
+//------------------------------------------------------------------------------
+void AsyncSink::drain()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakeup.notify_one();
+    while (!m_queue.empty() || m_busy.load())
+    {
+        m_drained.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+//------------------------------------------------------------------------------
+void AsyncSink::run()
+{
+    auto pop = [this](Record& record)
+    {
+        LogEntry const entry = { Severity(record.severity),
+                                 (record.chunk != nullptr) ? record.chunk : record.data,
+                                 record.length, record.prefix };
+        m_sink->consume(entry);
+        ChunkPool::release(record.chunk, record.capacity);
+    };
+
+    for (;;)
+    {
+        m_busy = true;
+        while (m_queue.pop(pop))
+            ;
+        m_sink->idle();
+        m_busy = false;
+        m_drained.notify_all();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_running && m_queue.empty())
+            return ;
+        if (m_queue.empty())
+        {
+            m_wakeup.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+}
+
+} // namespace mylogger
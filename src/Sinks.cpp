@@ -0,0 +1,217 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Sinks.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+namespace mylogger {
+
+//------------------------------------------------------------------------------
+FileSink::FileSink(std::string const& path, FlushPolicy const& policy)
+    : m_path(path)
+{
+    m_file.policy(policy);
+    if (!m_file.open(path))
+    {
+        std::cerr << "Failed creating the log file '" << path
+                  << "'. Reason is '" << strerror(errno) << "'"
+                  << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------
+void FileSink::write(LogEntry const& entry, const char* text, size_t const length)
+{
+    m_file.write(text, length, entry.severity);
+}
+
+//------------------------------------------------------------------------------
+void FileSink::idle()
+{
+    m_file.flushIfExpired();
+}
+
+//------------------------------------------------------------------------------
+RotatingFileSink::RotatingFileSink(std::string const& path, RotationPolicy const& rotation,
+                                   FlushPolicy const& policy)
+    : FileSink(path, policy)
+{
+    m_archiver.policy(rotation);
+}
+
+//------------------------------------------------------------------------------
+void RotatingFileSink::write(LogEntry const& entry, const char* text, size_t const length)
+{
+    FileSink::write(entry, text, length);
+    if (!m_archiver.enabled() || !m_archiver.due(m_file.size()))
+        return ;
+
+    m_file.close();
+    std::string const incoming = m_archiver.incoming(m_path);
+    if (m_file.open(incoming))
+    {
+        m_archiver.archive(m_path, incoming);
+    }
+    else
+    {
+        m_file.open(m_path, true);
+    }
+}
+
+//------------------------------------------------------------------------------
+void ConsoleSink::write(LogEntry const& entry, const char* text, size_t const length)
+{
+    m_console.write(entry.severity, text, length);
+}
+
+//------------------------------------------------------------------------------
+MemorySink::MemorySink(size_t const capacity)
+    : m_ring(std::max(capacity, size_t(1u)))
+{}
+
+//------------------------------------------------------------------------------
+void MemorySink::write(LogEntry const& /*entry*/, const char* text, size_t length)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Only the end of lines larger than the ring is kept.
+    if (length > m_ring.size())
+    {
+        m_written += length - m_ring.size();
+        text += length - m_ring.size();
+        length = m_ring.size();
+    }
+
+    size_t const start = size_t(m_written % m_ring.size());
+    size_t const n = std::min(length, m_ring.size() - start);
+    memcpy(m_ring.data() + start, text, n);
+    memcpy(m_ring.data(), text + n, length - n);
+    m_written += length;
+}
+
+//------------------------------------------------------------------------------
+std::string MemorySink::content() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_written <= m_ring.size())
+        return std::string(m_ring.data(), size_t(m_written));
+
+    // The ring has wrapped: skip the partially overwritten oldest line.
+    size_t const start = size_t(m_written % m_ring.size());
+    std::string text(m_ring.data() + start, m_ring.size() - start);
+    text.append(m_ring.data(), start);
+    std::string::size_type const eol = text.find('\n');
+    return (eol == std::string::npos) ? std::string() : text.substr(eol + 1u);
+}
+
+#if !defined(_WIN32)
+
+constexpr int SyslogSink::c_user;
+
+//------------------------------------------------------------------------------
+SyslogSink::SyslogSink(std::string const& tag, int const facility, std::string const& path)
+    : m_tag(tag), m_facility(facility)
+{
+    // Syslog adds its own time: only send the message.
+    formatter([](LogEntry const& entry, char* buffer, size_t const size)
+    {
+        size_t const n = std::min(entry.messageLength(), size);
+        memcpy(buffer, entry.message(), n);
+        return n;
+    });
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof (address.sun_path) - 1u);
+
+    m_socket = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    if ((m_socket >= 0) &&
+        (::connect(m_socket, reinterpret_cast<struct sockaddr*>(&address),
+                   sizeof (address)) != 0))
+    {
+        std::cerr << "Failed connecting to syslog '" << path
+                  << "'. Reason is '" << strerror(errno) << "'"
+                  << std::endl;
+        ::close(m_socket);
+        m_socket = -1;
+    }
+}
+
+//------------------------------------------------------------------------------
+SyslogSink::~SyslogSink()
+{
+    if (m_socket >= 0)
+    {
+        ::close(m_socket);
+    }
+}
+
+//------------------------------------------------------------------------------
+int SyslogSink::level(enum Severity const severity)
+{
+    // LOG_CRIT = 2, LOG_ERR = 3, LOG_WARNING = 4, LOG_INFO = 6, LOG_DEBUG = 7
+    switch (severity)
+    {
+    case Debug: return 7;
+    case Warning: case Catch: return 4;
+    case Failed: case Error: case Exception: return 3;
+    case Signal: case Fatal: return 2;
+    default: return 6;
+    }
+}
+
+//------------------------------------------------------------------------------
+void SyslogSink::write(LogEntry const& entry, const char* text, size_t length)
+{
+    if (m_socket < 0)
+        return ;
+
+    // Syslog messages are single lines.
+    while ((length > 0u) && (text[length - 1u] == '\n'))
+    {
+        --length;
+    }
+
+    char datagram[2048];
+    int n = snprintf(datagram, sizeof (datagram), "<%d>%s: %.*s",
+                     m_facility * 8 + level(entry.severity), m_tag.c_str(),
+                     int(length), text);
+    if (n > 0)
+    {
+        ::send(m_socket, datagram, std::min(size_t(n), sizeof (datagram) - 1u), MSG_DONTWAIT);
+    }
+}
+
+#endif // !_WIN32
+
+} // namespace mylogger
@@ -0,0 +1,68 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "MyLogger/Site.hpp"
+#include <mutex>
+#include <cstdlib>
+#include <iostream>
+
+namespace mylogger {
+
+std::atomic<Site*> Sites::s_chunks[Sites::c_max_sites / Sites::c_chunk_size];
+std::atomic<uint32_t> Sites::s_size(0u);
+
+//! \brief Serialize registrations.
+static std::mutex s_mutex;
+
+//------------------------------------------------------------------------------
+uint32_t Sites::add(enum Severity const severity, const char* file,
+                    int const line, const char* format)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    uint32_t const id = s_size.load(std::memory_order_relaxed);
+    if (id >= c_max_sites)
+    {
+        std::cerr << "Too many log statements" << std::endl;
+        abort();
+    }
+
+    Site* chunk = s_chunks[id >> c_chunk_bits].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+        chunk = new Site[c_chunk_size];
+        s_chunks[id >> c_chunk_bits].store(chunk, std::memory_order_release);
+    }
+
+    Site& site = chunk[id & (c_chunk_size - 1u)];
+    site.severity = severity;
+    site.file = file;
+    site.line = line;
+    site.format = format;
+    if (file != nullptr)
+    {
+        site.location = "[" + std::string(file) + "::" + std::to_string(line) + "] ";
+    }
+
+    s_size.store(id + 1u, std::memory_order_release);
+    return id;
+}
+
+} // namespace mylogger
@@ -0,0 +1,120 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <fstream>
+#include <string>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+static std::string decode(std::string const& data, binary::Filter const& filter = binary::Filter())
+{
+    binary::Reader reader(data.data(), data.size(), filter);
+    std::string text, line;
+
+    EXPECT_TRUE(reader.valid());
+    while (reader.next(line))
+      {
+        text += line;
+      }
+    return text;
+}
+
+//--------------------------------------------------------------------------
+static void logSomething(int const i)
+{
+    LOGI("Hello World from thread %3u", unsigned(i));
+}
+
+//--------------------------------------------------------------------------
+TEST(BinaryLogTests, testRoundTrip)
+{
+    Logger::instance().fileFormat(FileFormat::Binary);
+    Logger::instance().changeLog("/tmp/MyLogger/binary.bin");
+    LOGI("int %d str %s dbl %.2f char %c", -42, "hello", 3.14159, 'x');
+    LOGW("unsigned %u hex %lx width %*d", 7u, 0xffUL, 4, 5);
+    LOGB("basic %d", 1);
+    CPP_LOG(mylogger::Error) << "stream " << 5;
+
+    // The writer thread stores the same records.
+    Logger::instance().startAsync();
+    LOGE("async %s", "error");
+    Logger::instance().stopAsync();
+    Logger::destroy();
+
+    std::string const data = content("/tmp/MyLogger/binary.bin");
+    ASSERT_EQ(0, memcmp(data.data(), binary::c_magic, sizeof (binary::c_magic)));
+    ASSERT_EQ(std::string::npos, data.find("int -42"));
+
+    std::string const text = decode(data);
+    ASSERT_NE(std::string::npos, text.find("==="));
+    ASSERT_NE(std::string::npos, text.find("[INFO][BinaryLogTests.cpp::"));
+    ASSERT_NE(std::string::npos, text.find("] int -42 str hello dbl 3.14 char x\n"));
+    ASSERT_NE(std::string::npos, text.find("] unsigned 7 hex ff width    5\n"));
+    ASSERT_NE(std::string::npos, text.find("]basic 1\n"));
+    ASSERT_NE(std::string::npos, text.find("[ERROR][BinaryLogTests.cpp::"));
+    ASSERT_NE(std::string::npos, text.find("] stream 5\n"));
+    ASSERT_NE(std::string::npos, text.find("] async error\n"));
+
+    // Filters
+    binary::Filter filter;
+    filter.severity = Warning;
+    std::string filtered = decode(data, filter);
+    ASSERT_EQ(std::string::npos, filtered.find("int -42"));
+    ASSERT_EQ(std::string::npos, filtered.find("basic 1"));
+    ASSERT_NE(std::string::npos, filtered.find("unsigned 7"));
+    ASSERT_NE(std::string::npos, filtered.find("async error"));
+
+    filter = binary::Filter();
+    filter.file = "Other.cpp";
+    ASSERT_EQ("", decode(data, filter));
+
+    filter = binary::Filter();
+    filter.to = 1000000000u;
+    ASSERT_EQ("", decode(data, filter));
+}
+
+//--------------------------------------------------------------------------
+TEST(BinaryLogTests, testSmallerThanText)
+{
+    Logger::instance().changeLog("/tmp/MyLogger/text.log");
+    for (int i = 0; i < 1000; ++i)
+      {
+        logSomething(i);
+      }
+    Logger::destroy();
+
+    Logger::instance().fileFormat(FileFormat::Binary);
+    Logger::instance().changeLog("/tmp/MyLogger/text.bin");
+    for (int i = 0; i < 1000; ++i)
+      {
+        logSomething(i);
+      }
+    Logger::destroy();
+
+    std::string const text = content("/tmp/MyLogger/text.log");
+    std::string const data = content("/tmp/MyLogger/text.bin");
+    ASSERT_LT(3u * data.size(), text.size());
+    ASSERT_NE(std::string::npos, decode(data).find("] Hello World from thread 999\n"));
+}
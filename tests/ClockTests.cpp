@@ -0,0 +1,94 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include "MyLogger/Clock.hpp"
+#include <cstdlib>
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief Compare the cached formatting with strftime.
+//--------------------------------------------------------------------------
+TEST(ClockTests, testFormat)
+{
+    char buffer[32];
+    char expected[32];
+    time_t const now = time(nullptr);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    strftime(expected, sizeof (expected), "[%H:%M:%S", &tm);
+
+    Timestamp when = { uint64_t(now) * 1000000000u + 123456789u, false };
+
+    Clock::precision(TimePrecision::Seconds);
+    ASSERT_EQ(10u, Clock::format(buffer, sizeof (buffer), when));
+    ASSERT_EQ(std::string(expected) + "]", buffer);
+
+    Clock::precision(TimePrecision::Milliseconds);
+    Clock::format(buffer, sizeof (buffer), when);
+    ASSERT_EQ(std::string(expected) + ".123]", buffer);
+
+    Clock::precision(TimePrecision::Nanoseconds);
+    Clock::format(buffer, sizeof (buffer), when);
+    ASSERT_EQ(std::string(expected) + ".123456789]", buffer);
+
+    // Leading zeros and cache of the same second
+    when.value = uint64_t(now) * 1000000000u + 1000u;
+    Clock::precision(TimePrecision::Microseconds);
+    ASSERT_EQ(17u, Clock::format(buffer, sizeof (buffer), when));
+    ASSERT_EQ(std::string(expected) + ".000001]", buffer);
+
+    // Truncation
+    ASSERT_EQ(4u, Clock::format(buffer, 5u, when));
+    ASSERT_EQ(std::string(expected).substr(0u, 4u), buffer);
+
+    // Shared cache of the local time
+    char date[32];
+    strftime(date, sizeof (date), "%Y/%m/%d %H:%M:%S", &tm);
+    LocalTime const& local = Clock::local(now);
+    ASSERT_EQ(std::string(date, 10u), std::string(local.date, sizeof (local.date)));
+    ASSERT_EQ(std::string(date + 11, 8u), std::string(local.hms, sizeof (local.hms)));
+    ASSERT_EQ(tm.tm_min, local.tm.tm_min);
+
+    // Restore the default precision for the other tests
+    Clock::precision(TimePrecision::Seconds);
+}
+
+//--------------------------------------------------------------------------
+//! \brief All sources give about the same date.
+//--------------------------------------------------------------------------
+TEST(ClockTests, testSources)
+{
+    Clock::source(ClockSource::Precise);
+    uint64_t const precise = Clock::nanoseconds(Clock::now());
+
+    Clock::source(ClockSource::Coarse);
+    Timestamp const coarse = Clock::now();
+    ASSERT_FALSE(coarse.tsc);
+    ASSERT_LT(std::llabs(int64_t(Clock::nanoseconds(coarse) - precise)), 100000000ll);
+
+    Clock::source(ClockSource::Tsc);
+    Timestamp const tsc = Clock::now();
+    ASSERT_LT(std::llabs(int64_t(Clock::nanoseconds(tsc) - precise)), 100000000ll);
+
+    Clock::source(ClockSource::Precise);
+    ASSERT_FALSE(Clock::now().tsc);
+}
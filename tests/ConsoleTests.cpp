@@ -0,0 +1,187 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "main.hpp"
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+// *****************************************************************************
+//! \brief Non-blocking pipe, optionally replacing a file descriptor (the
+//! standard output or error) during its life.
+// *****************************************************************************
+class Pipe
+{
+public:
+
+    explicit Pipe(int const replaced = -1)
+        : m_replaced(replaced)
+    {
+        EXPECT_EQ(0, ::pipe(m_fds));
+        fcntl(m_fds[0], F_SETFL, O_NONBLOCK);
+        if (m_replaced >= 0)
+        {
+            m_saved = ::dup(m_replaced);
+            ::dup2(m_fds[1], m_replaced);
+        }
+    }
+
+    ~Pipe()
+    {
+        if (m_replaced >= 0)
+        {
+            ::dup2(m_saved, m_replaced);
+            ::close(m_saved);
+        }
+        ::close(m_fds[0]);
+        ::close(m_fds[1]);
+    }
+
+    //! \brief Write end.
+    int fd() const
+    {
+        return m_fds[1];
+    }
+
+    //! \brief Read what has been written so far.
+    std::string read()
+    {
+        std::string text;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = ::read(m_fds[0], buffer, sizeof (buffer))) > 0)
+          {
+            text.append(buffer, size_t(n));
+          }
+        return text;
+    }
+
+private:
+
+    int m_fds[2];
+    int m_replaced;
+    int m_saved = -1;
+};
+
+//--------------------------------------------------------------------------
+TEST(ConsoleTests, testWrite)
+{
+    Pipe pipe;
+
+    Console colored(pipe.fd(), ColorMode::Always);
+    ASSERT_TRUE(colored.colored());
+    colored.write(Warning, "hello\n", 6u);
+    colored.write(Fatal, "no eol", 6u);
+    colored.write(None, "raw\n", 4u);
+    ASSERT_EQ("\033[33mhello\033[0m\n\033[1;37;41mno eol\033[0mraw\n", pipe.read());
+
+    Console plain(pipe.fd(), ColorMode::Never);
+    ASSERT_FALSE(plain.colored());
+    plain.write(Warning, "hello\n", 6u);
+    ASSERT_EQ("hello\n", pipe.read());
+
+    // A pipe is not a terminal.
+    ASSERT_FALSE(Console(pipe.fd()).colored());
+}
+
+//--------------------------------------------------------------------------
+TEST(ConsoleTests, testBatch)
+{
+    Pipe pipe;
+    Console console(pipe.fd(), ColorMode::Always);
+
+    console.append(Error, "first\n", 6u);
+    console.append(Info, "second\n", 7u);
+    ASSERT_EQ("", pipe.read());
+    console.flush();
+    ASSERT_EQ("\033[31mfirst\033[0m\n\033[32msecond\033[0m\n", pipe.read());
+
+    // Written when the batch is full, in order.
+    std::string const line(1000u, 'x');
+    std::string expected;
+    console.colors(ColorMode::Never);
+    for (int i = 0; i < 40; ++i)
+      {
+        console.append(Info, line.c_str(), line.size());
+        expected += line;
+      }
+    std::string text = pipe.read();
+    ASSERT_LT(0u, text.size());
+    ASSERT_GT(expected.size(), text.size());
+    console.flush();
+    text += pipe.read();
+    ASSERT_EQ(expected, text);
+
+    // Longer than the batch.
+    std::string const longer(Console::c_batch_size + 1u, 'y');
+    console.append(Info, longer.c_str(), longer.size());
+    ASSERT_EQ(longer, pipe.read());
+}
+
+//--------------------------------------------------------------------------
+TEST(ConsoleTests, testLogger)
+{
+    Pipe pipe(2);
+
+    for (int async = 0; async <= 1; ++async)
+      {
+        Logger::instance().changeLog("/tmp/MyLogger/console.log");
+        Logger::instance().consoleColors(ColorMode::Always);
+        if (async)
+          {
+            Logger::instance().startAsync();
+          }
+        LOGES("error %d", async);
+        LOGWS("warning %d", async);
+        Logger::destroy();
+
+        std::string const text = pipe.read();
+        std::string const error = "error " + std::to_string(async) + "\033[0m\n";
+        std::string const warning = "warning " + std::to_string(async) + "\033[0m\n";
+        ASSERT_EQ(0u, text.find("\033[31m")) << text;
+        ASSERT_NE(std::string::npos, text.find("[ERROR]"));
+        ASSERT_LT(text.find(error), text.find("\033[33m"));
+        ASSERT_EQ(text.size() - warning.size(), text.find(warning));
+      }
+}
+
+//--------------------------------------------------------------------------
+TEST(ConsoleTests, testFlightRecorder)
+{
+    Pipe pipe;
+
+    ASSERT_TRUE(FlightRecorder::start("/tmp/MyLogger/flight.log", 8u));
+    FlightRecorder::console(pipe.fd(), ColorMode::Always);
+    FlightRecorder::record("info\n", 5u, Info);
+    FlightRecorder::record("error\n", 6u, Error);
+    ASSERT_TRUE(FlightRecorder::dump());
+    FlightRecorder::console(-1);
+    FlightRecorder::stop();
+
+    std::string const text = pipe.read();
+    ASSERT_NE(std::string::npos, text.find("Flight recorder"));
+    ASSERT_NE(std::string::npos, text.find("\033[32minfo\033[0m\n\033[31merror\033[0m\n"));
+}
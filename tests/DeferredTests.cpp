@@ -0,0 +1,124 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <fstream>
+#include <string>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief Encode then format the arguments and compare with snprintf.
+//--------------------------------------------------------------------------
+template <class... Args>
+static void check(const char* format, Args... args)
+{
+    char record[1024];
+    char expected[1024];
+    char result[1024];
+
+    deferred::Header const header = { 0u, { 0u, false } };
+    size_t length = deferred::encode(record, sizeof (record), header, args...);
+    deferred::format(result, sizeof (result), format, record, length);
+    snprintf(expected, sizeof (expected), format, args...);
+    ASSERT_STREQ(expected, result);
+}
+
+//--------------------------------------------------------------------------
+TEST(DeferredTests, testFormat)
+{
+    check("no argument");
+    check("100%% sure");
+    check("%d %i %5d %-5d| %05d %+d", 42, -42, 42, 42, 42, 42);
+    check("%u %x %X %#o %lu %llu", 42u, 255u, 255u, 8u, 42ul, 42ull);
+    check("%hhd %hd %ld %lld %zu", (signed char) -1, (short) -2, -3l, -4ll, size_t(5));
+    check("%f %.2f %10.3e %g", 3.14159, 2.71828, 1e10, 0.5f);
+    check("%s [%10s] [%-10s] %.3s", "hello", "right", "left", "truncated");
+    check("%c%c%c", 'a', 'b', 'c');
+    check("%*d|%-*d|%.*f", 6, 42, 6, 42, 2, 3.14159);
+    check("%p", (void*) 0x1234);
+    check("[%s::%d] %s %d", "file.cpp", 42, "extra", Warning, "");
+
+    // Missing argument does not read garbage
+    char record[256];
+    char result[256];
+    deferred::Header const header = { 0u, { 0u, false } };
+    size_t length = deferred::encode(record, sizeof (record), header, 42);
+    deferred::format(result, sizeof (result), "%d %s", record, length);
+    ASSERT_STREQ("42 ?", result);
+}
+
+//--------------------------------------------------------------------------
+TEST(DeferredTests, testAsyncLogger)
+{
+    Logger::instance().changeLog("/tmp/MyLogger/deferred.log");
+    Logger::instance().startAsync(64u, QueueFullPolicy::Block);
+    uint32_t site = Sites::add(Warning, "file.cpp", 42, "%s %d %.1f");
+    for (int i = 0; i < 100; ++i)
+      {
+        std::string tmp("temporary string");
+        Logger::instance().logDeferred(nullptr, site, tmp.c_str(), i, 0.5);
+      }
+    Logger::destroy();
+
+    std::ifstream file("/tmp/MyLogger/deferred.log");
+    std::string line;
+    int count = 0;
+    while (std::getline(file, line))
+      {
+        if (line.find("[WARNING]") != std::string::npos)
+          {
+            std::string expected = "[WARNING][file.cpp::42] temporary string "
+                                   + std::to_string(count++) + " 0.5";
+            ASSERT_NE(std::string::npos, line.find(expected)) << line;
+          }
+      }
+    ASSERT_EQ(100, count);
+}
+
+//--------------------------------------------------------------------------
+TEST(DeferredTests, testSites)
+{
+    static_assert(File::baseName("/foo/bar/file.cpp")[0] == 'f', "constexpr");
+    ASSERT_STREQ("file.cpp", File::baseName("/foo/bar/file.cpp"));
+    ASSERT_STREQ("file.cpp", File::baseName("foo\\file.cpp"));
+    ASSERT_STREQ("file.cpp", File::baseName("file.cpp"));
+    ASSERT_STREQ("", File::baseName("/foo/"));
+    ASSERT_STREQ("DeferredTests.cpp", SHORT_FILENAME);
+
+    uint32_t id = Sites::add(Error, "file.cpp", 42, "%d");
+    ASSERT_LT(id, Sites::size());
+    ASSERT_EQ(Error, Sites::get(id).severity);
+    ASSERT_EQ(42, Sites::get(id).line);
+    ASSERT_STREQ("%d", Sites::get(id).format);
+    ASSERT_STREQ("[file.cpp::42] ", Sites::get(id).location.c_str());
+
+    // The same log statement is only registered once
+    uint32_t sites[2];
+    for (int i = 0; i < 2; ++i)
+      {
+        static const uint32_t site = Sites::add(Info, SHORT_FILENAME, __LINE__, "");
+        sites[i] = site;
+      }
+    ASSERT_EQ(sites[0], sites[1]);
+}
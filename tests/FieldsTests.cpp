@@ -0,0 +1,146 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "main.hpp"
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <string>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#define private public
+#  include "MyLogger/Fields.hpp"
+#undef private
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief Return the line of the log containing the given text, without the
+//! values of its time and line fields.
+//--------------------------------------------------------------------------
+static std::string line(std::string const& log, std::string const& what)
+{
+    size_t const found = log.find(what);
+    if (found == std::string::npos)
+        return "";
+
+    size_t const begin = log.rfind('\n', found) + 1u;
+    std::string text = log.substr(begin, log.find('\n', found) - begin);
+    for (const char* key: { "time", "line" })
+      {
+        size_t const found = text.find(key);
+        if (found == std::string::npos)
+          continue;
+        size_t const start = text.find_first_of("0123456789", found);
+        size_t const end = text.find_first_not_of("0123456789", start);
+        text.erase(start, end - start);
+      }
+    return text;
+}
+
+//--------------------------------------------------------------------------
+TEST(FieldsTests, testEscape)
+{
+    char output[64];
+    const char input[] = "a\"b\\c\nd\te\x01" "f";
+    size_t const n = Fields::escape(output, input, sizeof (input) - 1u);
+    ASSERT_EQ("a\\\"b\\\\c\\nd\\te\\u0001f", std::string(output, n));
+    ASSERT_EQ(0u, Fields::escape(output, "", 0u));
+}
+
+//--------------------------------------------------------------------------
+TEST(FieldsTests, testFormats)
+{
+    const char* path = "/tmp/MyLogger/fields.log";
+    std::string const name("Joe \"the\" user");
+
+    Logger::instance().changeLog(path);
+    Fields::format(FieldFormat::Json);
+    LOGI_KV("login", "user", name, "id", 42, "admin", false);
+    LOGW_KV("slow\trequest", "latency_us", 12.5, "bytes", uint64_t(18446744073709551615u),
+            "delta", -7, "ratio", NAN, "grade", 'A', "none", static_cast<const char*>(nullptr));
+    Fields::format(FieldFormat::Logfmt);
+    LOGI_KV("login", "user", name, "id", 42, "admin", true, "empty", "");
+    LOGE_KV("failed", "path", "/tmp/a=b", "code", -1);
+    Fields::format(FieldFormat::Text);
+    LOGI_KV("plain", "user", "Joe", "id", 42);
+    Logger::destroy();
+
+    std::string const log = content(path);
+    ASSERT_EQ("{\"time\":,\"level\":\"INFO\",\"file\":\"FieldsTests.cpp\",\"line\":,"
+              "\"msg\":\"login\",\"user\":\"Joe \\\"the\\\" user\",\"id\":42,\"admin\":false}",
+              line(log, "\"login\""));
+    ASSERT_EQ("{\"time\":,\"level\":\"WARNING\",\"file\":\"FieldsTests.cpp\",\"line\":,"
+              "\"msg\":\"slow\\trequest\",\"latency_us\":12.5,\"bytes\":18446744073709551615,"
+              "\"delta\":-7,\"ratio\":null,\"grade\":\"A\",\"none\":null}",
+              line(log, "slow"));
+    ASSERT_EQ("time= level=INFO file=FieldsTests.cpp line= msg=login "
+              "user=\"Joe \\\"the\\\" user\" id=42 admin=true empty=\"\"",
+              line(log, "msg=login"));
+    ASSERT_EQ("time= level=ERROR file=FieldsTests.cpp line= msg=failed "
+              "path=\"/tmp/a=b\" code=-1",
+              line(log, "msg=failed"));
+    std::string const text = line(log, "plain");
+    ASSERT_NE(std::string::npos, text.find("][INFO][FieldsTests.cpp::"));
+    ASSERT_EQ(text.size() - 22u, text.find("] plain user=Joe id=42"));
+}
+
+//--------------------------------------------------------------------------
+TEST(FieldsTests, testDisabled)
+{
+    int evaluated = 0;
+
+    Logger::instance().changeLog("/tmp/MyLogger/fields.log");
+    ILogger::threshold(Warning);
+    LOGI_KV("skipped", "value", ++evaluated);
+    LOGW_KV("kept", "value", ++evaluated);
+    ILogger::threshold(None);
+    Logger::destroy();
+
+    ASSERT_EQ(1, evaluated);
+    std::string const log = content("/tmp/MyLogger/fields.log");
+    ASSERT_EQ(std::string::npos, log.find("skipped"));
+    ASSERT_NE(std::string::npos, log.find("kept value=1\n"));
+}
+
+//--------------------------------------------------------------------------
+//! \brief Out of memory after a truncated field: the string value is dropped
+//! instead of being written past the end of the line.
+//--------------------------------------------------------------------------
+TEST(FieldsTests, testOutOfMemory)
+{
+    char buffer[64];
+    LineBuffer storage(buffer, sizeof (buffer));
+    std::string const text(sizeof (buffer), 'x');
+    size_t const huge = std::numeric_limits<size_t>::max() / 16u;
+
+    Fields::format(FieldFormat::Json);
+    Fields fields(storage, 0u);
+    fields.append(text.data(), huge);
+    ASSERT_EQ(sizeof (buffer) - 2u, fields.m_length);
+    ASSERT_TRUE(fields.m_truncated);
+
+    fields.string(text.data(), huge);
+    ASSERT_EQ(sizeof (buffer) - 2u, fields.m_length);
+    ASSERT_EQ(buffer, storage.data());
+    Fields::format(FieldFormat::Text);
+}
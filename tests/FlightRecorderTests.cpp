@@ -0,0 +1,122 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+TEST(FlightRecorderTests, testDumpOnFatal)
+{
+    remove("/tmp/MyLogger/flight.log");
+    ASSERT_TRUE(FlightRecorder::start("/tmp/MyLogger/flight.log", 8u));
+    ILogger::threshold(Info);
+    Logger::instance().changeLog("/tmp/MyLogger/recorded.log");
+
+    // Below the threshold: only kept by the flight recorder.
+    for (int i = 0; i < 20; ++i)
+      {
+        LOGD("debug %d", i);
+      }
+    ASSERT_EQ("", content("/tmp/MyLogger/flight.log"));
+    LOGA("fatal %d", 42);
+    Logger::destroy();
+    FlightRecorder::stop();
+    ILogger::threshold(None);
+
+    std::string const dump = content("/tmp/MyLogger/flight.log");
+    ASSERT_EQ(std::string::npos, dump.find("debug 12\n"));
+    ASSERT_NE(std::string::npos, dump.find("] debug 13\n"));
+    ASSERT_NE(std::string::npos, dump.find("] debug 19\n"));
+    ASSERT_NE(std::string::npos, dump.find("[FATAL][FlightRecorderTests.cpp::"));
+    ASSERT_LT(dump.find("debug 19"), dump.find("fatal 42"));
+
+    std::string const log = content("/tmp/MyLogger/recorded.log");
+    ASSERT_EQ(std::string::npos, log.find("debug"));
+    ASSERT_NE(std::string::npos, log.find("] fatal 42\n"));
+}
+
+//--------------------------------------------------------------------------
+TEST(FlightRecorderTests, testConcurrentRecords)
+{
+    constexpr int num_threads = 4;
+    constexpr int lines = 10000;
+
+    ASSERT_TRUE(FlightRecorder::start("/tmp/MyLogger/flight.log", 1000u));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+      {
+        threads.push_back(std::thread([t]()
+        {
+            char line[64];
+            for (int i = 0; i < lines; ++i)
+              {
+                int n = snprintf(line, sizeof (line), "thread %d line %d\n", t, i);
+                FlightRecorder::record(line, size_t(n));
+              }
+        }));
+      }
+    for (auto& it: threads)
+      {
+        it.join();
+      }
+    ASSERT_TRUE(FlightRecorder::dump());
+    FlightRecorder::stop();
+    ASSERT_FALSE(FlightRecorder::dump());
+
+    // The ring holds the 1024 most recent lines, each one complete.
+    std::istringstream dump(content("/tmp/MyLogger/flight.log"));
+    std::string line;
+    int count = 0, thread, index;
+    std::getline(dump, line);
+    while (std::getline(dump, line))
+      {
+        ASSERT_EQ(2, sscanf(line.c_str(), "thread %d line %d", &thread, &index)) << line;
+        ++count;
+      }
+    ASSERT_EQ(1024, count);
+}
+
+#if !defined(_WIN32)
+//--------------------------------------------------------------------------
+TEST(FlightRecorderTests, testDumpOnSignal)
+{
+    remove("/tmp/MyLogger/crash.log");
+    ASSERT_EXIT(
+    {
+        FlightRecorder::start("/tmp/MyLogger/crash.log", 16u);
+        FlightRecorder::installSignalHandlers();
+        FlightRecorder::record("before the crash\n", 17u);
+        abort();
+    }, ::testing::KilledBySignal(SIGABRT), "");
+
+    ASSERT_NE(std::string::npos, content("/tmp/MyLogger/crash.log").find("before the crash\n"));
+}
+#endif
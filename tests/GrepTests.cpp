@@ -0,0 +1,238 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+#  include "MyLogger/Grep.hpp"
+
+using namespace mylogger;
+
+//! \brief A log file over midnight with a banner, a multi-line message and
+//! stamped lines.
+static const std::string c_log =
+    "======\n"
+    "   Release 0.0 - Event log - [2019/06/01]\n"
+    "[23:58:59.900000][INFO][main.cpp::10] starting\n"
+    "[23:59:00.000000][ERROR][net.cpp::42] timeout on [main.cpp::10]\n"
+    "second line of the timeout\n"
+    "[23:59:30.500][WARNING][main.cpp::12] slow\n"
+    "[00:00:01.000000]basic line\n"
+    "{1559347201000000000 12:3}[00:00:01.000001][FATAL][main.cpp::12] crash\n"
+    "[00:01:00.000000][DEBUG][net.cpp::7] retry";
+
+//--------------------------------------------------------------------------
+static std::vector<std::string> grep(Grep::Query const& query,
+                                     LogIndex const* index = nullptr,
+                                     std::string const& log = c_log)
+{
+    Grep search(log.data(), log.size(), query, index);
+    std::vector<std::string> lines;
+    Grep::Line line;
+    while (search.next(line))
+      {
+        lines.push_back(std::string(line.text, line.length));
+      }
+    return lines;
+}
+
+//--------------------------------------------------------------------------
+static int64_t at(int64_t const h, int64_t const m, int64_t const s)
+{
+    return ((h * 60 + m) * 60 + s) * 1000000000;
+}
+
+//--------------------------------------------------------------------------
+TEST(GrepTests, testParse)
+{
+    std::string line = "[23:59:30.500][WARNING][main.cpp::12] slow\n";
+    LineInfo info = LineInfo::parse(line.data(), line.size());
+    ASSERT_EQ(at(23, 59, 30) + 500000000, info.time);
+    ASSERT_EQ(Warning, info.severity);
+    ASSERT_EQ("main.cpp::12", std::string(info.location, info.location_length));
+
+    line = "{1559347201000000000 12:3}[00:00:01.000001][FATAL][main.cpp::12] crash";
+    info = LineInfo::parse(line.data(), line.size());
+    ASSERT_EQ(at(0, 0, 1) + 1000, info.time);
+    ASSERT_EQ(Fatal, info.severity);
+
+    line = "[00:00:01]basic [line]\n";
+    info = LineInfo::parse(line.data(), line.size());
+    ASSERT_EQ(at(0, 0, 1), info.time);
+    ASSERT_EQ(None, info.severity);
+    ASSERT_EQ(nullptr, info.location);
+
+    line = "second line of the timeout\n";
+    info = LineInfo::parse(line.data(), line.size());
+    ASSERT_EQ(-1, info.time);
+    ASSERT_EQ(None, info.severity);
+}
+
+//--------------------------------------------------------------------------
+TEST(GrepTests, testQueries)
+{
+    Grep::Query query;
+    ASSERT_EQ(9u, grep(query).size());
+
+    query.severity = Error;
+    std::vector<std::string> lines = grep(query);
+    ASSERT_EQ(2u, lines.size());
+    ASSERT_EQ("[23:59:00.000000][ERROR][net.cpp::42] timeout on [main.cpp::10]\n", lines[0]);
+    ASSERT_EQ("[00:01:00.000000][DEBUG][net.cpp::7] retry", grep(Grep::Query()).back());
+
+    // Debug is below Info
+    query.severity = Info;
+    ASSERT_EQ(4u, grep(query).size());
+    query.severity = Debug;
+    ASSERT_EQ(5u, grep(query).size());
+
+    // Location of the file or of the log statement, not inside messages
+    query = Grep::Query();
+    query.location = "main.cpp";
+    ASSERT_EQ(3u, grep(query).size());
+    query.location = "main.cpp::10";
+    lines = grep(query);
+    ASSERT_EQ(1u, lines.size());
+    ASSERT_EQ("[23:58:59.900000][INFO][main.cpp::10] starting\n", lines[0]);
+    query.location = "main.cpp::1";
+    ASSERT_EQ(0u, grep(query).size());
+
+    // Text, combined with a severity
+    query = Grep::Query();
+    query.text = "line";
+    ASSERT_EQ(2u, grep(query).size());
+    query.severity = Info;
+    ASSERT_EQ(0u, grep(query).size());
+
+    // Time range, through midnight
+    query = Grep::Query();
+    query.from = at(23, 59, 0);
+    query.to = at(0, 0, 1);
+    lines = grep(query);
+    ASSERT_EQ(3u, lines.size());
+    ASSERT_EQ("[00:00:01.000000]basic line\n", lines[2]);
+    query.to = at(0, 0, 2);
+    ASSERT_EQ(4u, grep(query).size());
+}
+
+//--------------------------------------------------------------------------
+TEST(GrepTests, testIndex)
+{
+    LogIndex index;
+    index.update(c_log.data(), c_log.size());
+
+    // The unterminated last line is not indexed.
+    ASSERT_EQ(c_log.rfind('\n') + 1u, index.size());
+    auto const& entries = index.entries();
+    ASSERT_EQ(4u, entries.size());
+    ASSERT_EQ(-1, entries[0].minute);
+    ASSERT_EQ(23 * 60 + 58, entries[1].minute);
+    ASSERT_EQ(23 * 60 + 59, entries[2].minute);
+    ASSERT_EQ((1u << None) | (1u << Error) | (1u << Warning), entries[2].severities);
+    ASSERT_EQ(0, entries[3].minute);
+
+    // Same results with and without index, runs without match are skipped.
+    Grep::Query query;
+    query.severity = Error;
+    ASSERT_EQ(grep(query), grep(query, &index));
+    Grep skipping(c_log.data(), c_log.size(), query, &index);
+    ASSERT_EQ(entries[2].offset, skipping.skipped());
+    query.severity = Info;
+    ASSERT_EQ(grep(query), grep(query, &index));
+    query = Grep::Query();
+    query.from = at(0, 0, 0);
+    query.to = at(0, 0, 30);
+    ASSERT_EQ(grep(query), grep(query, &index));
+    ASSERT_EQ(2u, grep(query, &index).size());
+
+    // Appended lines
+    std::string const log = c_log + "\n[00:02:00.000000][FATAL][main.cpp::20] appended\n";
+    ASSERT_TRUE(index.covers(log.data(), log.size()));
+    query = Grep::Query();
+    query.severity = Fatal;
+    ASSERT_EQ(2u, grep(query, &index, log).size());
+    index.update(log.data(), log.size());
+    ASSERT_EQ(log.size(), index.size());
+    ASSERT_EQ(6u, index.entries().size());
+    ASSERT_EQ(2u, grep(query, &index, log).size());
+
+    // Saved and loaded
+    std::string const path = LogIndex::path("/tmp/MyLogger/grep.log");
+    ASSERT_EQ("/tmp/MyLogger/grep.log.idx", path);
+    ASSERT_TRUE(index.save(path));
+    LogIndex loaded;
+    ASSERT_TRUE(loaded.load(path));
+    ASSERT_EQ(index.size(), loaded.size());
+    ASSERT_EQ(index.entries().size(), loaded.entries().size());
+    ASSERT_EQ(grep(query, &index, log), grep(query, &loaded, log));
+
+    // Another content is not covered: the index is ignored, then rebuilt.
+    std::string const other = "[10:00:00.000000][FATAL][other.cpp::1] other\n";
+    ASSERT_FALSE(loaded.covers(other.data(), other.size()));
+    ASSERT_EQ(1u, grep(query, &loaded, other).size());
+    loaded.update(other.data(), other.size());
+    ASSERT_EQ(1u, loaded.entries().size());
+    ASSERT_FALSE(loaded.load("/tmp/MyLogger/missing.idx"));
+
+    // Truncated or corrupt sidecar: rejected, the index is kept
+    std::string sidecar = content(path);
+    std::ofstream(path, std::ios::binary) << sidecar.substr(0u, sidecar.size() - 1u);
+    ASSERT_FALSE(loaded.load(path));
+    sidecar.replace(24u, 8u, 8u, '\xff');
+    std::ofstream(path, std::ios::binary) << sidecar;
+    ASSERT_FALSE(loaded.load(path));
+    ASSERT_EQ(1u, loaded.entries().size());
+}
+
+//--------------------------------------------------------------------------
+TEST(GrepTests, testLogFile)
+{
+    const char* path = "/tmp/MyLogger/grep.log";
+    Logger::instance().changeLog(path);
+    for (int i = 0; i < 100; ++i)
+      {
+        LOGI("line %d", i);
+        if (i % 10 == 0)
+          {
+            LOGE("error %d", i);
+          }
+      }
+    Logger::destroy();
+
+    std::ifstream file(path);
+    std::string const log((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+    LogIndex index;
+    index.update(log.data(), log.size());
+
+    Grep::Query query;
+    query.severity = Error;
+    ASSERT_EQ(10u, grep(query, &index, log).size());
+    query.text = "error 50";
+    ASSERT_EQ(1u, grep(query, &index, log).size());
+    query = Grep::Query();
+    query.location = "GrepTests.cpp";
+    ASSERT_EQ(110u, grep(query, nullptr, log).size());
+}
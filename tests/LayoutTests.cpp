@@ -0,0 +1,126 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "main.hpp"
+#include <fstream>
+#include <string>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief Format the beginning of a line of the given layout.
+//--------------------------------------------------------------------------
+static std::string format(Layout const& layout, layout::Context const& context,
+                          size_t const size = 256u)
+{
+    char buffer[256];
+    size_t const n = layout.format(buffer, size, context);
+    EXPECT_EQ(n, strlen(buffer));
+    return std::string(buffer, n);
+}
+
+//--------------------------------------------------------------------------
+TEST(LayoutTests, testDefault)
+{
+    uint32_t const id = Sites::add(Warning, "foo.cpp", 42, "");
+    Timestamp const when = Clock::now();
+    char time[32];
+    Clock::format(time, sizeof (time), when);
+
+    Layout const layout;
+    ASSERT_EQ(std::string(time) + "[WARNING][foo.cpp::42] ",
+              format(layout, { Warning, &Sites::get(id), when }));
+    ASSERT_EQ(std::string(time) + "[INFO]", format(layout, { Info, nullptr, when }));
+    ASSERT_EQ(std::string(time), format(layout, { None, nullptr, when }));
+}
+
+//--------------------------------------------------------------------------
+TEST(LayoutTests, testPattern)
+{
+    uint32_t const id = Sites::add(Error, "foo.cpp", 42, "");
+    Timestamp const when = { 1559390400123456789u, false }; // 2019/06/01 12:00:00 UTC
+
+    time_t const second = Clock::seconds(when);
+    struct tm tm;
+    localtime_r(&second, &tm);
+    char date[32];
+    strftime(date, sizeof (date), "%Y/%m/%d %H:%M:%S", &tm);
+
+    Layout layout;
+    ASSERT_TRUE(layout.compile("%D %T.%e|%u|%n %L [%f:%l] 100%% %m"));
+    ASSERT_EQ(std::string(date) + ".123|123456|123456789 ERROR [foo.cpp:42] 100% ",
+              format(layout, { Error, &Sites::get(id), when }));
+    ASSERT_EQ(std::string(date) + ".123|123456|123456789 INFO [:] 100% ",
+              format(layout, { Info, nullptr, when }));
+
+    // Truncated
+    ASSERT_EQ(std::string(date).substr(0u, 5u), format(layout, { Error, nullptr, when }, 6u));
+    ASSERT_EQ("", format(layout, { Error, nullptr, when }, 1u));
+
+    // Invalid patterns do not change the layout.
+    ASSERT_FALSE(layout.compile("%m %L"));
+    ASSERT_FALSE(layout.compile("%L %"));
+    ASSERT_FALSE(layout.compile("%L %z"));
+    ASSERT_EQ(std::string(date) + ".123|123456|123456789 ERROR [foo.cpp:42] 100% ",
+              format(layout, { Error, &Sites::get(id), when }));
+    ASSERT_TRUE(layout.compile(""));
+    ASSERT_EQ("", format(layout, { Error, &Sites::get(id), when }));
+}
+
+//--------------------------------------------------------------------------
+TEST(LayoutTests, testCompiled)
+{
+    uint32_t const id = Sites::add(Info, "foo.cpp", 42, "");
+    Timestamp const when = Clock::now();
+    layout::Context const context = { Info, &Sites::get(id), when };
+
+    Layout const parsed("%T.%u %L [%f:%l] ");
+    Layout const compiled = Layout::of<layout::Hms, layout::Text<'.'>, layout::Micros,
+                                       layout::Text<' '>, layout::Level,
+                                       layout::Text<' ', '['>, layout::Filename,
+                                       layout::Text<':'>, layout::Line,
+                                       layout::Text<']', ' '>>();
+    ASSERT_EQ(format(parsed, context), format(compiled, context));
+    ASSERT_EQ(format(parsed, context, 10u), format(compiled, context, 10u));
+}
+
+//--------------------------------------------------------------------------
+TEST(LayoutTests, testLogger)
+{
+    const char* path = "/tmp/MyLogger/layout.log";
+
+    Logger::instance().changeLog(path);
+    Logger::instance().layout(Layout("%L %F%m"));
+    LOGI("Hello %d", 42);
+    CPP_LOG(Warning) << "World";
+    Logger::instance().log(nullptr, Error, "Direct");
+    Logger::instance().layout(Layout());
+    Logger::destroy();
+
+    std::string const log = content(path);
+    ASSERT_NE(std::string::npos, log.find("\nINFO [LayoutTests.cpp::"));
+    ASSERT_NE(std::string::npos, log.find("] Hello 42\n"));
+    ASSERT_NE(std::string::npos, log.find("\nWARNING [LayoutTests.cpp::"));
+    ASSERT_NE(std::string::npos, log.find("\nERROR Direct\n"));
+}
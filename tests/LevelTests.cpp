@@ -0,0 +1,222 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Statements below Warning are removed from this file.
+#define MYLOGGER_MIN_SEVERITY mylogger::Warning
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+static int evaluations = 0;
+
+//--------------------------------------------------------------------------
+static int evaluated()
+{
+    return ++evaluations;
+}
+
+//--------------------------------------------------------------------------
+TEST(LevelTests, testThresholds)
+{
+    const char* path = "/tmp/MyLogger/level.log";
+    Logger::instance().changeLog(path);
+
+    // Compile-time threshold
+    evaluations = 0;
+    LOGI("removed %d", evaluated());
+    LOGD("removed %d", evaluated());
+    LOGIS("removed %d", evaluated());
+    LOGW("kept %d", evaluated());
+    ASSERT_EQ(1, evaluations);
+
+    // Runtime threshold
+    ILogger::threshold(Error);
+    ASSERT_EQ(Error, ILogger::threshold());
+    LOGW("filtered %d", evaluated());
+    LOGF("filtered %d", evaluated());
+    LOGWS("filtered %d", evaluated());
+    LOGE("kept %d", evaluated());
+    LOGA("kept %d", evaluated());
+    LOGB("kept %d", evaluated());
+    ASSERT_EQ(4, evaluations);
+
+    ILogger::threshold(None);
+    LOGW("kept %d", evaluated());
+    ASSERT_EQ(5, evaluations);
+    Logger::destroy();
+
+    std::string const text = content(path);
+    ASSERT_EQ(std::string::npos, text.find("removed"));
+    ASSERT_EQ(std::string::npos, text.find("filtered"));
+    ASSERT_NE(std::string::npos, text.find("[WARNING][LevelTests.cpp::53] kept 1"));
+    ASSERT_NE(std::string::npos, text.find("[ERROR][LevelTests.cpp::62] kept 2"));
+    ASSERT_NE(std::string::npos, text.find("[FATAL][LevelTests.cpp::63] kept 3"));
+    ASSERT_NE(std::string::npos, text.find("]kept 4\n"));
+    ASSERT_NE(std::string::npos, text.find("kept 5"));
+}
+
+//--------------------------------------------------------------------------
+TEST(LevelTests, testOrder)
+{
+    static_assert(rank(None) < rank(Debug), "None is the lowest");
+    static_assert(rank(Debug) < rank(Info), "Debug is below Info");
+    static_assert(rank(Info) < rank(Warning), "Info is below Warning");
+    ASSERT_EQ(Debug, Severity(rank(Info)));
+    ASSERT_EQ(Info, Severity(rank(Debug)));
+
+    // A threshold at Info keeps Info but filters Debug
+    ILogger::threshold(Info);
+    ASSERT_FALSE(ILogger::enabled(Debug));
+    ASSERT_FALSE(ILogger::written(Debug));
+    ASSERT_TRUE(ILogger::enabled(Info));
+    ASSERT_TRUE(ILogger::written(Info));
+    ASSERT_TRUE(ILogger::enabled(Warning));
+
+    ILogger::threshold(Debug);
+    ASSERT_TRUE(ILogger::enabled(Debug));
+    ASSERT_TRUE(ILogger::enabled(Info));
+    ILogger::threshold(None);
+}
+
+//--------------------------------------------------------------------------
+TEST(LevelTests, testSeverityNames)
+{
+    enum Severity severity = None;
+    ASSERT_TRUE(ILogger::severity("error", severity));
+    ASSERT_EQ(Error, severity);
+    ASSERT_TRUE(ILogger::severity("[Debug]", severity));
+    ASSERT_EQ(Debug, severity);
+    ASSERT_TRUE(ILogger::severity("FAILURE", severity));
+    ASSERT_EQ(Failed, severity);
+
+    ASSERT_FALSE(ILogger::severity("err", severity));
+    ASSERT_FALSE(ILogger::severity("[ERROR", severity));
+    ASSERT_FALSE(ILogger::severity("", severity));
+    ASSERT_EQ(Failed, severity);
+}
+
+//--------------------------------------------------------------------------
+TEST(LevelTests, testLazyArguments)
+{
+    const char* path = "/tmp/MyLogger/level.log";
+    Logger::instance().changeLog(path);
+
+    int calls = 0;
+    auto dump = [&calls]() { ++calls; return std::string("dumped"); };
+    auto count = [&calls]() { return ++calls; };
+
+    // Callables of filtered statements are not called
+    ILogger::threshold(Error);
+    LOGW("filtered %s %d", dump, count);
+    LOGW_KV("filtered", "state", dump);
+    LOG_UNIQUE(Warning, "filtered %s", dump);
+    ASSERT_EQ(0, calls);
+    ILogger::threshold(None);
+
+    // Callables of logged statements are called once
+    LOGW("lazy %s %d", dump, count);
+    ASSERT_EQ(2, calls);
+    LOGW_KV("lazy", "state", dump, "count", count);
+    ASSERT_EQ(4, calls);
+    for (int i = 0; i < 10; ++i)
+      {
+        LOG_EVERY_N(Warning, 5, "every %d", count);
+      }
+    ASSERT_EQ(6, calls);
+    LOG_UNIQUE(Warning, "unique %s", dump);
+    ASSERT_EQ(7, calls);
+
+    // std::string is given to %s
+    std::string const name("Joe");
+    LOGW("string %s", name);
+    Logger::destroy();
+
+    std::string const text = content(path);
+    ASSERT_EQ(std::string::npos, text.find("filtered"));
+    ASSERT_NE(std::string::npos, text.find("lazy dumped "));
+    ASSERT_NE(std::string::npos, text.find("lazy state=dumped count=4\n"));
+    ASSERT_NE(std::string::npos, text.find("every 5\n"));
+    ASSERT_NE(std::string::npos, text.find("every 6\n"));
+    ASSERT_NE(std::string::npos, text.find("unique dumped\n"));
+    ASSERT_NE(std::string::npos, text.find("string Joe\n"));
+}
+
+// *************************************************************************
+//! \brief Sink blocking the writer thread until it is released.
+// *************************************************************************
+class GateSink: public ISink
+{
+public:
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> released{false};
+
+private:
+
+    virtual void write(LogEntry const&, const char*, size_t const) override
+    {
+        entered = true;
+        while (!released)
+          {
+            std::this_thread::yield();
+          }
+    }
+};
+
+//--------------------------------------------------------------------------
+TEST(LevelTests, testFullQueue)
+{
+    Logger::instance().changeLog("/tmp/MyLogger/level.log");
+    auto sink = std::make_shared<GateSink>();
+    Logger::instance().addSink(sink);
+    Logger::instance().startAsync(2u, QueueFullPolicy::Drop);
+
+    // The writer thread is blocked by the sink, then the queue is filled
+    LOGW("blocking");
+    while (!sink->entered)
+      {
+        std::this_thread::yield();
+      }
+    LOGW("queued 1");
+    LOGW("queued 2");
+    uint64_t const dropped = Logger::instance().dropped();
+
+    // Arguments of dropped lines are not evaluated
+    evaluations = 0;
+    for (int i = 0; i < 10; ++i)
+      {
+        LOGW("dropped %d", evaluated());
+      }
+    uint64_t const lost = Logger::instance().dropped() - dropped;
+
+    sink->released = true;
+    Logger::instance().stopAsync();
+    Logger::destroy();
+
+    ASSERT_EQ(0, evaluations);
+    ASSERT_EQ(10u, lost);
+}
@@ -0,0 +1,102 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <fstream>
+#include <string>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief A payload of the given size ending by a recognizable tail.
+//--------------------------------------------------------------------------
+static std::string payload(size_t const size)
+{
+    std::string text(size, 'x');
+    for (size_t i = 0u; i < size; i += 64u)
+      {
+        text[i] = char('a' + (i / 64u) % 26u);
+      }
+    text.replace(size - 4u, 4u, "TAIL");
+    return text;
+}
+
+//--------------------------------------------------------------------------
+TEST(LineBufferTests, testGrow)
+{
+    char buffer[16];
+    uint64_t const allocations = ChunkPool::allocations();
+    {
+        LineBuffer line(buffer, sizeof (buffer));
+        ASSERT_TRUE(line.reserve(16u, 0u));
+        ASSERT_EQ(buffer, line.data());
+
+        memcpy(line.data(), "hello", 5u);
+        ASSERT_TRUE(line.reserve(100000u, 5u));
+        ASSERT_NE(buffer, line.data());
+        ASSERT_GE(line.size(), 100000u);
+        ASSERT_EQ(0, memcmp(line.data(), "hello", 5u));
+    }
+
+    // The chunk is reused instead of allocated again.
+    uint64_t const after = ChunkPool::allocations();
+    ASSERT_LE(after, allocations + 1u);
+    {
+        LineBuffer line(buffer, sizeof (buffer));
+        ASSERT_TRUE(line.reserve(100000u, 0u));
+    }
+    ASSERT_EQ(after, ChunkPool::allocations());
+    ASSERT_GE(ChunkPool::cached(), 100000u);
+}
+
+//--------------------------------------------------------------------------
+TEST(LineBufferTests, testLongLines)
+{
+    const size_t sizes[] = { 1024u, 64u * 1024u, 1024u * 1024u };
+
+    for (bool const async: { false, true })
+      {
+        Logger::instance().changeLog("/tmp/MyLogger/long.log");
+        if (async)
+          {
+            Logger::instance().startAsync(16u);
+          }
+        for (size_t const size: sizes)
+          {
+            std::string const text = payload(size);
+            LOGI("printf %s", text.c_str());
+            CPP_LOG(Info) << "stream " << text;
+            Logger::instance().log(nullptr, Info, "direct %s", text.c_str());
+          }
+        Logger::destroy();
+
+        std::string const log = content("/tmp/MyLogger/long.log");
+        for (size_t const size: sizes)
+          {
+            std::string const text = payload(size);
+            ASSERT_NE(std::string::npos, log.find("] printf " + text + "\n")) << size;
+            ASSERT_NE(std::string::npos, log.find("] stream " + text + "\n")) << size;
+            ASSERT_NE(std::string::npos, log.find("[INFO]direct " + text + "\n")) << size;
+          }
+      }
+}
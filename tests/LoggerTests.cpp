@@ -23,6 +23,9 @@
 #include <algorithm>
 #include <iterator>
 #include <cstring>
+#include <vector>
+#include <cstdio>
+#include <zlib.h>
 
 #define SINGLETON_FOR_LOGGER Singleton<Logger>
 
@@ -172,3 +175,359 @@ TEST(LoggerTests, testWithConcurrency)
     uint32_t lines = number_of_lines(project::info2.log_path);
     ASSERT_EQ(num_threads * lines_by_thread + header_footer_lines, lines);
   }
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testCppLogWithConcurrency)
+{
+    constexpr uint32_t num_threads = 10U;
+    constexpr uint32_t lines_by_thread = 100U;
+    const char* path = "/tmp/MyLogger/cpplog.log";
+
+    Logger::instance().changeLog(path);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0U; i < num_threads; ++i)
+      {
+        threads.emplace_back([i]()
+        {
+          for (uint32_t l = 0U; l < lines_by_thread; ++l)
+            {
+              CPP_LOG(Info) << "thread " << i << " line " << int(l) - 50
+                            << ' ' << 0.5 << ' ' << std::string("end");
+            }
+        });
+      }
+    for (auto& it: threads)
+      {
+        it.join();
+      }
+    Logger::destroy();
+
+    // Each line is complete
+    std::ifstream file(path);
+    std::string line;
+    uint32_t count = 0U;
+    while (std::getline(file, line))
+      {
+        if (line.find("thread ") != std::string::npos)
+          {
+            ++count;
+            ASSERT_NE(std::string::npos, line.find("[INFO][LoggerTests.cpp::"));
+            ASSERT_NE(std::string::npos, line.find(" 0.5 end"));
+            ASSERT_EQ(line.size(), line.find(" 0.5 end") + strlen(" 0.5 end"));
+          }
+      }
+    ASSERT_EQ(num_threads * lines_by_thread, count);
+    ASSERT_EQ(num_threads * lines_by_thread + header_footer_lines, number_of_lines(path));
+}
+
+//--------------------------------------------------------------------------
+//! \brief Like std::ostream, CPP_LOG writes characters and not their code.
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testCppLogCharacters)
+{
+    const char* path = "/tmp/MyLogger/cpplog.log";
+
+    Logger::instance().changeLog(path);
+    CPP_LOG(Info) << "chars " << 'A' << uint8_t('B') << int8_t('C')
+                  << static_cast<unsigned char>('D') << static_cast<signed char>('E')
+                  << ' ' << int16_t(70) << ' ' << uint16_t(71);
+    Logger::destroy();
+
+    ASSERT_NE(std::string::npos, content(path).find("] chars ABCDE 70 71\n"));
+}
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testAsyncWithConcurrency)
+{
+    constexpr uint32_t num_threads = 10U;
+    constexpr uint32_t lines_by_thread = 100U;
+
+    Logger::instance().changeLog("/tmp/MyLogger/async.log");
+    Logger::instance().startAsync(16u, QueueFullPolicy::Block);
+
+    std::thread t[num_threads];
+    for (uint32_t i = 0; i < num_threads; ++i)
+      {
+        t[i] = std::thread(call_from_thread, i, lines_by_thread);
+      }
+    for (uint32_t i = 0; i < num_threads; ++i)
+      {
+        t[i].join();
+      }
+    ASSERT_EQ(0u, Logger::instance().dropped());
+    Logger::destroy();
+
+    uint32_t lines = number_of_lines("/tmp/MyLogger/async.log");
+    ASSERT_EQ(num_threads * lines_by_thread + header_footer_lines, lines);
+  }
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testChangeLogWhileLogging)
+{
+    constexpr uint32_t num_threads = 4U;
+    constexpr uint32_t lines_by_thread = 2000U;
+    constexpr uint32_t num_files = 20U;
+
+    for (bool const async: { false, true })
+      {
+        Logger::instance().changeLog("/tmp/MyLogger/switch0.log");
+        if (async)
+          {
+            Logger::instance().startAsync(64u, QueueFullPolicy::Block);
+          }
+
+        std::thread t[num_threads];
+        for (uint32_t i = 0; i < num_threads; ++i)
+          {
+            t[i] = std::thread(call_from_thread, i, lines_by_thread);
+          }
+        for (uint32_t f = 1U; f < num_files; ++f)
+          {
+            ASSERT_TRUE(Logger::instance().changeLog(
+                "/tmp/MyLogger/switch" + std::to_string(f) + ".log"));
+          }
+        for (uint32_t i = 0; i < num_threads; ++i)
+          {
+            t[i].join();
+          }
+        Logger::destroy();
+
+        // No line is lost and each file has its header and its footer around
+        // its lines.
+        size_t lines = 0u;
+        for (uint32_t f = 0U; f < num_files; ++f)
+          {
+            std::string const text =
+              content("/tmp/MyLogger/switch" + std::to_string(f) + ".log");
+            size_t const footer = text.find("log closed at");
+            ASSERT_EQ(0u, text.find("======")) << f;
+            ASSERT_NE(std::string::npos, footer) << f;
+            for (size_t pos = text.find("Hello World"); pos != std::string::npos;
+                 pos = text.find("Hello World", pos + 1u))
+              {
+                ASSERT_LT(pos, footer) << f;
+                ++lines;
+              }
+          }
+        ASSERT_EQ(num_threads * lines_by_thread, lines);
+      }
+  }
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testStreamWhileChangeLog)
+{
+    constexpr uint32_t num_threads = 4U;
+    constexpr uint32_t lines_by_thread = 2000U;
+    constexpr uint32_t num_files = 20U;
+
+    Logger::instance().changeLog("/tmp/MyLogger/stream0.log");
+    std::thread t[num_threads];
+    for (uint32_t i = 0; i < num_threads; ++i)
+      {
+        t[i] = std::thread([]()
+        {
+          for (uint32_t l = 0; l < lines_by_thread; ++l)
+            {
+              Logger::instance() << "Streamed line\n";
+            }
+        });
+      }
+    for (uint32_t f = 1U; f < num_files; ++f)
+      {
+        ASSERT_TRUE(Logger::instance().changeLog(
+            "/tmp/MyLogger/stream" + std::to_string(f) + ".log"));
+      }
+    for (uint32_t i = 0; i < num_threads; ++i)
+      {
+        t[i].join();
+      }
+    Logger::destroy();
+
+    // Whole lines, all of them inside a file.
+    size_t lines = 0u;
+    for (uint32_t f = 0U; f < num_files; ++f)
+      {
+        std::string const text =
+          content("/tmp/MyLogger/stream" + std::to_string(f) + ".log");
+        size_t const footer = text.find("log closed at");
+        ASSERT_NE(std::string::npos, footer) << f;
+        for (size_t pos = text.find("Streamed line\n"); pos != std::string::npos;
+             pos = text.find("Streamed line\n", pos + 1u))
+          {
+            ASSERT_LT(pos, footer) << f;
+            ++lines;
+          }
+      }
+    ASSERT_EQ(num_threads * lines_by_thread, lines);
+}
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testAsyncFullQueue)
+{
+    constexpr uint32_t lines_by_thread = 1000U;
+    const QueueFullPolicy policies[] = { QueueFullPolicy::Drop, QueueFullPolicy::Overwrite };
+
+    for (QueueFullPolicy policy: policies)
+      {
+        Logger::instance().changeLog("/tmp/MyLogger/async_full.log");
+        Logger::instance().startAsync(2u, policy);
+        call_from_thread(0u, lines_by_thread);
+        uint64_t dropped = Logger::instance().dropped();
+        Logger::destroy();
+
+        // The header and the footer are not queued: only lines are dropped.
+        uint32_t lines = number_of_lines("/tmp/MyLogger/async_full.log");
+        ASSERT_EQ(lines + dropped, lines_by_thread + header_footer_lines);
+      }
+  }
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testFlushPolicy)
+{
+    const char* path = "/tmp/MyLogger/flush.log";
+    FlushPolicy policy;
+    policy.bytes = 4096u;
+    policy.interval = std::chrono::milliseconds(60000);
+    policy.severity = Error;
+
+    Logger::instance().changeLog(path);
+    Logger::instance().flushPolicy(policy);
+
+    // Buffered lines are not yet in the file
+    uint64_t syscalls = Logger::instance().m_target.load()->file.syscalls();
+    LOGI("Buffered");
+    LOGW("Buffered");
+    ASSERT_EQ(syscalls, Logger::instance().m_target.load()->file.syscalls());
+    ASSERT_EQ(header_footer_lines - 5U, number_of_lines(path));
+
+    // Errors are written immediately with the previous lines in a single call
+    LOGE("Flushed");
+    ASSERT_EQ(syscalls + 1U, Logger::instance().m_target.load()->file.syscalls());
+    ASSERT_EQ(header_footer_lines - 5U + 3U, number_of_lines(path));
+
+    // Size threshold
+    for (int i = 0; i < 100; ++i)
+      {
+        LOGI("Line %d of a long text for reaching the threshold", i);
+      }
+    ASSERT_LT(syscalls + 1U, Logger::instance().m_target.load()->file.syscalls());
+    ASSERT_GT(syscalls + 10U, Logger::instance().m_target.load()->file.syscalls());
+
+    // Close flushes everything
+    Logger::destroy();
+    ASSERT_EQ(header_footer_lines + 103U, number_of_lines(path));
+}
+
+//--------------------------------------------------------------------------
+//! \brief Without a writer thread for flushing the buffered lines, the
+//! synchronous mode writes each line immediately by default.
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testDefaultFlushPolicy)
+{
+    const char* path = "/tmp/MyLogger/flush_default.log";
+
+    Logger::instance().changeLog(path);
+    uint64_t syscalls = Logger::instance().m_target.load()->file.syscalls();
+    LOGI("Written");
+    LOGW("Written");
+    ASSERT_EQ(syscalls + 2U, Logger::instance().m_target.load()->file.syscalls());
+    ASSERT_EQ(header_footer_lines - 5U + 2U, number_of_lines(path));
+
+    // Back to the synchronous mode
+    Logger::instance().startAsync();
+    LOGI("Queued");
+    Logger::instance().stopAsync();
+    ASSERT_EQ(header_footer_lines - 5U + 3U, number_of_lines(path));
+    LOGI("Written");
+    ASSERT_EQ(header_footer_lines - 5U + 4U, number_of_lines(path));
+
+    Logger::destroy();
+    ASSERT_EQ(header_footer_lines + 4U, number_of_lines(path));
+}
+
+//--------------------------------------------------------------------------
+static std::string gunzip(std::string const& file)
+{
+  std::string text;
+  char buffer[4096];
+  gzFile gz = gzopen(file.c_str(), "rb");
+  if (gz == nullptr)
+    return text;
+
+  int n;
+  while ((n = gzread(gz, buffer, sizeof (buffer))) > 0)
+    {
+      text.append(buffer, size_t(n));
+    }
+  gzclose(gz);
+  return text;
+}
+
+//--------------------------------------------------------------------------
+TEST(LoggerTests, testRotation)
+{
+    const std::string path = "/tmp/MyLogger/rotation.log";
+    ASSERT_EQ("/tmp/MyLogger/rotation.2.log", Archiver::generation(path, 2u));
+    ASSERT_EQ("/tmp/My.Logger/rotation.2", Archiver::generation("/tmp/My.Logger/rotation", 2u));
+
+    for (size_t i = 1u; i <= 5u; ++i)
+      {
+        std::remove(Archiver::generation(path, i).c_str());
+        std::remove((Archiver::generation(path, i) + ".gz").c_str());
+      }
+
+    // Compressed generations
+    RotationPolicy policy;
+    policy.bytes = 2048u;
+    policy.generations = 3u;
+    policy.compress = true;
+    Logger::instance().changeLog(path);
+    Logger::instance().rotationPolicy(policy);
+    for (int i = 0; i < 200; ++i)
+      {
+        LOGI("Line %d of a long text for reaching the threshold", i);
+      }
+    Logger::destroy();
+
+    for (size_t i = 1u; i <= 3u; ++i)
+      {
+        std::string const text = gunzip(Archiver::generation(path, i) + ".gz");
+        ASSERT_EQ(0u, text.find("======"));
+        ASSERT_NE(std::string::npos, text.find("log closed at"));
+        ASSERT_NE(std::string::npos, text.find("of a long text"));
+        ASSERT_FALSE(std::ifstream(Archiver::generation(path, i)).good());
+      }
+    ASSERT_FALSE(std::ifstream(Archiver::generation(path, 4u) + ".gz").good());
+    ASSERT_LE(header_footer_lines, number_of_lines(path));
+    ASSERT_EQ(0u, content(path).find("======"));
+    ASSERT_FALSE(std::ifstream(path + ".rotated").good());
+    ASSERT_FALSE(std::ifstream(path + ".incoming.1").good());
+
+    // Opening the log path again waits for the pending rotations
+    Logger::instance().changeLog(path);
+    Logger::instance().rotationPolicy(policy);
+    for (int i = 0; i < 200; ++i)
+      {
+        LOGI("Line %d of a long text for reaching the threshold", i);
+      }
+    Logger::instance().changeLog(path);
+    LOGI("Reopened");
+    Logger::destroy();
+    ASSERT_NE(std::string::npos, content(path).find("Reopened"));
+
+    // Plain generations, in asynchronous mode
+    policy.generations = 2u;
+    policy.compress = false;
+    Logger::instance().changeLog(path);
+    Logger::instance().rotationPolicy(policy);
+    Logger::instance().startAsync();
+    for (int i = 0; i < 200; ++i)
+      {
+        LOGI("Line %d of a long text for reaching the threshold", i);
+      }
+    Logger::destroy();
+
+    ASSERT_LT(header_footer_lines, number_of_lines(Archiver::generation(path, 1u)));
+    ASSERT_LT(header_footer_lines, number_of_lines(Archiver::generation(path, 2u)));
+    ASSERT_FALSE(std::ifstream(Archiver::generation(path, 3u)).good());
+}
@@ -0,0 +1,201 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "main.hpp"
+#include <fstream>
+#include <string>
+#include <thread>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+static Stats snapshot()
+{
+    Stats stats;
+    Metrics::collect(stats);
+    return stats;
+}
+
+//--------------------------------------------------------------------------
+static uint64_t samples(Stats const& stats)
+{
+    uint64_t count = 0u;
+    for (auto const it: stats.latency)
+      {
+        count += it;
+      }
+    return count;
+}
+
+//--------------------------------------------------------------------------
+TEST(MetricsTests, testHistogram)
+{
+    size_t previous = 0u;
+    for (uint64_t ns = 1u; ns < (uint64_t(1) << 40); ns += 1u + ns / 7u)
+      {
+        size_t const bucket = Histogram::bucket(ns);
+        ASSERT_LT(bucket, Histogram::c_buckets);
+        ASSERT_LE(previous, bucket);
+        ASSERT_LE(ns, Histogram::highest(bucket));
+        ASSERT_LE(Histogram::highest(bucket) - ns, ns / Histogram::c_sub_buckets);
+        previous = bucket;
+      }
+    ASSERT_EQ(Histogram::c_buckets - 1u, Histogram::bucket(UINT64_MAX));
+
+    Stats stats;
+    ASSERT_EQ(0u, stats.percentile(0.5));
+    stats.latency[Histogram::bucket(100u)] = 90u;
+    stats.latency[Histogram::bucket(10000u)] = 10u;
+    ASSERT_EQ(Histogram::highest(Histogram::bucket(100u)), stats.percentile(0.5));
+    ASSERT_EQ(Histogram::highest(Histogram::bucket(10000u)), stats.percentile(0.99));
+}
+
+//--------------------------------------------------------------------------
+TEST(MetricsTests, testCounters)
+{
+    const char* path = "/tmp/MyLogger/metrics.log";
+
+    Logger::instance().changeLog(path);
+    Stats const before = snapshot();
+
+    // Counters of terminated threads are kept.
+    std::thread thread([]()
+    {
+        for (int i = 0; i < 100; ++i)
+          {
+            LOGI("info %d", i);
+          }
+    });
+    thread.join();
+    for (int i = 0; i < 50; ++i)
+      {
+        LOGW("warning %d", i);
+        CPP_LOG(Error) << "error " << i;
+      }
+
+    Stats const after = Logger::instance().stats();
+    ASSERT_EQ(100u, after.lines[Info] - before.lines[Info]);
+    ASSERT_EQ(50u, after.lines[Warning] - before.lines[Warning]);
+    ASSERT_EQ(50u, after.lines[Error] - before.lines[Error]);
+    ASSERT_EQ(200u, after.total() - before.total());
+    ASSERT_LT(before.flushes, after.flushes); // Error lines are flushed
+    ASSERT_EQ(0u, after.queue_depth);
+
+    Logger::destroy();
+    std::ifstream file(path);
+    std::string line;
+    uint64_t bytes = 0u;
+    while (std::getline(file, line))
+      {
+        if (line.find("] info ") != std::string::npos ||
+            line.find("] warning ") != std::string::npos ||
+            line.find("] error ") != std::string::npos)
+          bytes += line.size() + 1u;
+      }
+    ASSERT_EQ(bytes, after.bytes - before.bytes);
+
+    char text[1024];
+    size_t const n = after.format(text, sizeof (text));
+    ASSERT_EQ(strlen(text), n);
+    ASSERT_EQ(0u, std::string(text).find("lines="));
+    ASSERT_NE(std::string::npos, std::string(text).find(" lines_warning="));
+    ASSERT_EQ(std::string::npos, std::string(text).find("latency"));
+    ASSERT_EQ(10u, after.format(text, 11u));
+}
+
+//--------------------------------------------------------------------------
+TEST(MetricsTests, testLatency)
+{
+    Logger::instance().changeLog("/tmp/MyLogger/metrics.log");
+
+    Stats const before = snapshot();
+    LOGI("not measured");
+    ASSERT_EQ(samples(before), samples(snapshot()));
+
+    Metrics::latency(true);
+    for (int i = 0; i < 1000; ++i)
+      {
+        LOGI("measured %d", i);
+      }
+    LOGI_KV("measured", "key", 1);
+    CPP_LOG(Info) << "measured";
+    Metrics::latency(false);
+
+    Stats const after = snapshot();
+    ASSERT_EQ(1002u, samples(after) - samples(before));
+    ASSERT_LT(0u, after.percentile(0.5));
+    ASSERT_LE(after.percentile(0.5), after.percentile(0.99));
+
+    char text[1024];
+    after.format(text, sizeof (text));
+    ASSERT_NE(std::string::npos, std::string(text).find(" latency_p99_ns="));
+    Logger::destroy();
+}
+
+//--------------------------------------------------------------------------
+TEST(MetricsTests, testDropped)
+{
+    Logger::instance().changeLog("/tmp/MyLogger/metrics.log");
+    Logger::instance().startAsync(2u, QueueFullPolicy::Drop);
+
+    Stats const before = snapshot();
+    for (int i = 0; i < 10000; ++i)
+      {
+        LOGI("line %d", i);
+      }
+    Logger::instance().stopAsync();
+    Stats const after = snapshot();
+
+    ASSERT_EQ(10000u, after.lines[Info] - before.lines[Info]);
+    ASSERT_EQ(Logger::instance().dropped(), after.dropped - before.dropped);
+    Logger::destroy();
+}
+
+//--------------------------------------------------------------------------
+TEST(MetricsTests, testPeriodicDump)
+{
+    const char* path = "/tmp/MyLogger/metrics.log";
+
+    for (int async = 0; async <= 1; ++async)
+      {
+        Logger::instance().changeLog(path);
+        if (async)
+          {
+            Logger::instance().startAsync();
+          }
+        Logger::instance().statsPeriod(std::chrono::milliseconds(1));
+        for (int i = 0; i < 5; ++i)
+          {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            LOGI("line %d", i);
+          }
+        Logger::destroy();
+
+        std::string const log = content(path);
+        size_t const found = log.find("[INFO][STATS] lines=");
+        ASSERT_NE(std::string::npos, found);
+        ASSERT_NE(std::string::npos, log.find(" bytes=", found));
+        ASSERT_NE(std::string::npos, log.find(" queue_depth=", found));
+      }
+}
@@ -0,0 +1,138 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#if !defined(_WIN32)
+
+#include "main.hpp"
+#include "MyLogger/MmapLogger.hpp"
+#include <csignal>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief Lines crossing segments shall be complete and the file shall
+//! not keep its pre-allocated tail.
+//--------------------------------------------------------------------------
+TEST(MmapLoggerTests, testConcurrency)
+{
+    constexpr uint32_t num_threads = 10U;
+    constexpr uint32_t lines_by_thread = 100U;
+    const char* path = "/tmp/MyLogger/mmap.log";
+
+    {
+        // Smallest segment: about 50 lines per segment.
+        MmapLogger logger(1u);
+        ASSERT_TRUE(logger.changeLog(path));
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0U; i < num_threads; ++i)
+        {
+            threads.emplace_back([&logger, i, lines_by_thread]()
+            {
+                for (uint32_t l = 0U; l < lines_by_thread; ++l)
+                {
+                    logger.log(nullptr, Info, "Hello World from thread %3u line %3u", i, l);
+                }
+            });
+        }
+        for (auto& it: threads)
+        {
+            it.join();
+        }
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    ASSERT_TRUE(!!file);
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string const text = content.str();
+
+    // No trailing zeros from the last pre-allocated segment.
+    ASSERT_EQ(std::string::npos, text.find('\0'));
+    ASSERT_EQ('\n', text.back());
+
+    std::istringstream lines(text);
+    std::string line;
+    uint32_t count = 0U;
+    uint32_t hello = 0U;
+    while (std::getline(lines, line))
+    {
+        ++count;
+        size_t pos = line.find("Hello World");
+        if (pos != std::string::npos)
+        {
+            ++hello;
+            ASSERT_NE(std::string::npos, line.find("[INFO]"));
+            ASSERT_EQ(line.size(), pos + strlen("Hello World from thread   0 line   0"));
+        }
+    }
+    ASSERT_EQ(num_threads * lines_by_thread, hello);
+    ASSERT_EQ(num_threads * lines_by_thread + 6U + 5U, count);
+}
+
+//--------------------------------------------------------------------------
+//! \brief Lines of a segment which cannot be allocated are dropped, but the
+//! slot of the segment is still freed for the next ones.
+//--------------------------------------------------------------------------
+TEST(MmapLoggerTests, testFailedSegment)
+{
+    const char* path = "/tmp/MyLogger/mmap_failed.log";
+    size_t const page = size_t(sysconf(_SC_PAGESIZE));
+    std::string const line(page / 8u, 'x');
+
+    struct rlimit limit;
+    ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &limit));
+    void (*previous)(int) = signal(SIGXFSZ, SIG_IGN);
+    {
+        MmapLogger logger(page);
+        ASSERT_TRUE(logger.changeLog(path));
+
+        // Segments 0 to 2 fit in the limit, segment 3 cannot be allocated.
+        struct rlimit small = limit;
+        small.rlim_cur = rlim_t(3u * page);
+        ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &small));
+        for (int i = 0; i < 28; ++i)
+        {
+            logger.log(nullptr, Info, "%s", line.c_str());
+        }
+        ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &limit));
+
+        // Following lines reuse the slot of segment 3 (segment 7 and more).
+        for (int i = 0; i < 64; ++i)
+        {
+            logger.log(nullptr, Info, "%s", line.c_str());
+        }
+        logger.log(nullptr, Info, "last line");
+    }
+    signal(SIGXFSZ, previous);
+
+    std::string const text = content(path);
+    ASSERT_NE(std::string::npos, text.find("last line"));
+    ASSERT_LT(7u * page, text.size());
+}
+
+#endif // !_WIN32
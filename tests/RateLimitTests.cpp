@@ -0,0 +1,133 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+static size_t occurrences(std::string const& text, std::string const& what)
+{
+    size_t count = 0u;
+    for (size_t pos = text.find(what); pos != std::string::npos;
+         pos = text.find(what, pos + 1u))
+      {
+        ++count;
+      }
+    return count;
+}
+
+//--------------------------------------------------------------------------
+TEST(RateLimitTests, testEveryN)
+{
+    int evaluated = 0;
+
+    Logger::instance().changeLog("/tmp/MyLogger/limit.log");
+    for (int i = 0; i < 10; ++i)
+      {
+        LOG_EVERY_N(Warning, 3, "every %d", (++evaluated, i));
+      }
+    Logger::destroy();
+
+    std::string const log = content("/tmp/MyLogger/limit.log");
+    ASSERT_EQ(4u, occurrences(log, "] every "));
+    ASSERT_NE(std::string::npos, log.find("] every 0\n"));
+    ASSERT_NE(std::string::npos, log.find("] every 3\n"));
+    ASSERT_NE(std::string::npos, log.find("] every 9\n"));
+    ASSERT_EQ(4, evaluated);
+}
+
+//--------------------------------------------------------------------------
+static void burst(int const i)
+{
+    LOG_PER_SECOND(Error, 5, "burst %d", i);
+}
+
+//--------------------------------------------------------------------------
+static void temperature(int const degrees)
+{
+    LOG_UNIQUE(Warning, "temperature %d %s", degrees, "too high");
+}
+
+//--------------------------------------------------------------------------
+TEST(RateLimitTests, testPerSecond)
+{
+    Logger::instance().changeLog("/tmp/MyLogger/limit.log");
+    for (int i = 0; i < 1000; ++i)
+      {
+        burst(i);
+      }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    burst(-1);
+    Logger::destroy();
+
+    // The first loop may span two seconds.
+    std::string const log = content("/tmp/MyLogger/limit.log");
+    size_t const logged = occurrences(log, "] burst ");
+    ASSERT_GE(logged, 6u);
+    ASSERT_LE(logged, 11u);
+    ASSERT_EQ(1u, occurrences(log, " similar lines suppressed\n"));
+    ASSERT_LT(log.find("similar lines suppressed"), log.find("] burst -1\n"));
+}
+
+//--------------------------------------------------------------------------
+TEST(RateLimitTests, testUnique)
+{
+    for (bool const binary: { false, true })
+      {
+        Logger::instance().fileFormat(binary ? FileFormat::Binary : FileFormat::Text);
+        Logger::instance().changeLog("/tmp/MyLogger/unique.log");
+        for (int i = 0; i < 5; ++i)
+          {
+            temperature(42);
+          }
+        temperature(43);
+        temperature(43);
+        temperature(44);
+        Logger::destroy();
+
+        Logger::instance().fileFormat(FileFormat::Text);
+
+        std::string log = content("/tmp/MyLogger/unique.log");
+        if (binary)
+          {
+            binary::Reader reader(log.data(), log.size(), binary::Filter());
+            std::string line;
+            log.clear();
+            while (reader.next(line))
+              {
+                log += line;
+              }
+          }
+        ASSERT_EQ(1u, occurrences(log, "] temperature 42 too high\n"));
+        ASSERT_EQ(1u, occurrences(log, "] temperature 43 too high\n"));
+        ASSERT_NE(std::string::npos, log.find("] last message repeated 4 times\n"));
+        ASSERT_LT(log.find("temperature 42"), log.find("last message repeated"));
+        ASSERT_LT(log.find("last message repeated"), log.find("temperature 43"));
+        ASSERT_NE(std::string::npos, log.find("] last message repeated 1 times\n"));
+      }
+}
@@ -0,0 +1,177 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+#include "main.hpp"
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+#  include "MyLogger/MmapLogger.hpp"
+#  include "MyLogger/Merger.hpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+static std::vector<std::string> merge(std::vector<std::string> const& inputs,
+                                      size_t const window, bool const strip)
+{
+    Merger merger(window);
+    for (auto const& it: inputs)
+      {
+        merger.add(it.data(), it.size());
+      }
+
+    std::vector<std::string> lines;
+    Merger::Line line;
+    while (merger.next(line))
+      {
+        size_t const skip = strip ? line.stamp : 0u;
+        lines.push_back(std::string(line.text + skip, line.length - skip));
+      }
+    return lines;
+}
+
+//--------------------------------------------------------------------------
+TEST(SequenceTests, testStamp)
+{
+    char buffer[64];
+    Timestamp const when = { 1559390400123456789u, false };
+    Stamp stamp;
+
+    Sequence::enable(false);
+    ASSERT_EQ(0u, Sequence::stamp(buffer, sizeof (buffer), when));
+
+    Sequence::enable(true);
+    size_t const n = Sequence::stamp(buffer, sizeof (buffer), when);
+    ASSERT_EQ(n, Sequence::parse(buffer, n, stamp));
+    ASSERT_EQ(1559390400123456789u, stamp.time);
+    ASSERT_EQ(Sequence::thread(), stamp.thread);
+    uint64_t const sequence = stamp.sequence;
+
+    // The buffer is too small: nothing written, but the line is counted.
+    ASSERT_EQ(0u, Sequence::stamp(buffer, 8u, when));
+    ASSERT_EQ(n, Sequence::stamp(buffer, sizeof (buffer), when));
+    ASSERT_EQ(n, Sequence::parse(buffer, n, stamp));
+    ASSERT_EQ(sequence + 2u, stamp.sequence);
+    Sequence::enable(false);
+
+    ASSERT_EQ(0u, Sequence::parse("[12:00:00]{1 2:3}", 17u, stamp));
+    ASSERT_EQ(0u, Sequence::parse("{1 2:3", 6u, stamp));
+    ASSERT_EQ(0u, Sequence::parse("{1 2 3}", 7u, stamp));
+    ASSERT_EQ(7u, Sequence::parse("{1 2:3}[INFO]", 13u, stamp));
+}
+
+//--------------------------------------------------------------------------
+TEST(SequenceTests, testMerge)
+{
+    std::vector<std::string> const inputs =
+    {
+        "banner A\n{10 1:0}a0\n{30 1:1}a1\nsecond line of a1\n{50 1:2}a2",
+        "{20 2:0}b0\n{15 3:0}c0\n{40 2:1}b1\n{60 2:2}b2\n"
+    };
+
+    // The unterminated last line is kept as is.
+    std::vector<std::string> const lines = merge(inputs, 4u, true);
+    std::vector<std::string> const expected =
+    {
+        "banner A\n", "a0\n", "c0\n", "b0\n", "a1\nsecond line of a1\n", "b1\n",
+        "a2", "b2\n"
+    };
+    ASSERT_EQ(expected, lines);
+
+    // Without enough lines read ahead, c0 is late.
+    std::vector<std::string> const late = merge(inputs, 1u, false);
+    ASSERT_EQ(8u, late.size());
+    ASSERT_EQ("{20 2:0}b0\n", late[2]);
+    ASSERT_EQ("{15 3:0}c0\n", late[3]);
+}
+
+//--------------------------------------------------------------------------
+TEST(SequenceTests, testMergeLogFiles)
+{
+    constexpr uint32_t num_threads = 4U;
+    constexpr uint32_t lines_by_thread = 500U;
+
+    // Two loggers of one process stand for several processes.
+    Sequence::enable(true);
+    Logger::instance().changeLog("/tmp/MyLogger/merge1.log");
+    Logger::instance().startAsync(64u);
+    {
+        MmapLogger other;
+        ASSERT_TRUE(other.changeLog("/tmp/MyLogger/merge2.log"));
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0U; i < num_threads; ++i)
+          {
+            threads.emplace_back([i, &other]()
+            {
+              for (uint32_t l = 0U; l < lines_by_thread; ++l)
+                {
+                  if (((i + l) & 1u) == 0u)
+                    {
+                      LOGI("thread %u line %u", i, l);
+                    }
+                  else
+                    {
+                      other.log(nullptr, Info, "thread %u line %u", i, l);
+                    }
+                }
+            });
+          }
+        for (auto& it: threads)
+          {
+            it.join();
+          }
+    }
+    Logger::destroy();
+    Sequence::enable(false);
+
+    std::vector<std::string> const inputs =
+    {
+        content("/tmp/MyLogger/merge1.log"), content("/tmp/MyLogger/merge2.log")
+    };
+    std::vector<std::string> const lines = merge(inputs, 1024u, false);
+
+    // Lines of each thread come back in the order they were logged.
+    std::map<uint32_t, uint64_t> next;
+    uint64_t time = 0u;
+    size_t count = 0u;
+    for (auto const& it: lines)
+      {
+        Stamp stamp;
+        if (Sequence::parse(it.data(), it.size(), stamp) == 0u)
+          continue;
+
+        ASSERT_LE(time, stamp.time);
+        time = stamp.time;
+        if (next.count(stamp.thread) != 0u)
+          {
+            ASSERT_EQ(next[stamp.thread], stamp.sequence);
+          }
+        next[stamp.thread] = stamp.sequence + 1u;
+        ++count;
+      }
+    ASSERT_EQ(num_threads * lines_by_thread, count);
+}
@@ -0,0 +1,129 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "MyLogger/Singleton.tpp"
+
+using namespace mylogger;
+
+//--------------------------------------------------------------------------
+//! \brief Singleton whose construction is slow enough to let threads race.
+//--------------------------------------------------------------------------
+template <template <class> class Policy>
+class Slow: public Policy<Slow<Policy>>
+{
+    friend class Policy<Slow<Policy>>;
+
+public:
+
+    static std::atomic<int> s_created;
+    int value;
+
+private:
+
+    Slow()
+    {
+        s_created.fetch_add(1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        value = 42;
+    }
+};
+
+template <template <class> class Policy>
+std::atomic<int> Slow<Policy>::s_created{0};
+
+//--------------------------------------------------------------------------
+//! \brief Call instance() for the first time from many threads at once.
+//! \return false if threads got different or unconstructed instances.
+//--------------------------------------------------------------------------
+template <class T>
+static bool race(size_t const num_threads)
+{
+    std::atomic<bool> go{false};
+    std::vector<T*> instances(num_threads, nullptr);
+    std::vector<int> values(num_threads, 0);
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0u; i < num_threads; ++i)
+      {
+        threads.push_back(std::thread([&, i]()
+        {
+            while (!go.load())
+              {
+                std::this_thread::yield();
+              }
+            instances[i] = &T::instance();
+            values[i] = instances[i]->value;
+        }));
+      }
+    go = true;
+    for (auto& it: threads)
+      {
+        it.join();
+      }
+
+    for (size_t i = 0u; i < num_threads; ++i)
+      {
+        if ((instances[i] != instances[0]) || (values[i] != 42))
+          return false;
+      }
+    return true;
+}
+
+//--------------------------------------------------------------------------
+TEST(SingletonTests, testLazyRace)
+{
+    typedef Slow<LazySingleton> Lazy;
+
+    for (int round = 1; round <= 20; ++round)
+      {
+        ASSERT_TRUE(race<Lazy>(32u));
+        ASSERT_EQ(round, Lazy::s_created.load());
+        Lazy::destroy();
+      }
+}
+
+//--------------------------------------------------------------------------
+TEST(SingletonTests, testRegularRace)
+{
+    typedef Slow<Singleton> Regular;
+
+    for (int round = 1; round <= 20; ++round)
+      {
+        ASSERT_TRUE(race<Regular>(32u));
+        ASSERT_EQ(round, Regular::s_created.load());
+        Regular::destroy();
+      }
+}
+
+//--------------------------------------------------------------------------
+TEST(SingletonTests, testThreadCachedRace)
+{
+    typedef Slow<ThreadCachedSingleton> Cached;
+
+    ASSERT_TRUE(race<Cached>(32u));
+    ASSERT_TRUE(race<Cached>(32u));
+    ASSERT_EQ(1, Cached::s_created.load());
+}
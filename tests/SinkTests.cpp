@@ -0,0 +1,174 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+#include "main.hpp"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+#if !defined(_WIN32)
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+#define SINGLETON_FOR_LOGGER Singleton<Logger>
+#  include "MyLogger/Logger.hpp"
+
+using namespace mylogger;
+
+// *****************************************************************************
+//! \brief Sink taking time for each line.
+// *****************************************************************************
+class SlowSink: public ISink
+{
+public:
+
+    uint32_t lines = 0u;
+
+private:
+
+    virtual void write(LogEntry const&, const char*, size_t const) override
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++lines;
+    }
+};
+
+//--------------------------------------------------------------------------
+TEST(SinkTests, testFanOut)
+{
+    auto memory = std::make_shared<MemorySink>();
+    memory->threshold(Warning);
+    auto file = std::make_shared<FileSink>("/tmp/MyLogger/sink.log");
+    file->formatter([](LogEntry const& entry, char* buffer, size_t const size)
+    {
+        int n = snprintf(buffer, size, "%s|%.*s", ILogger::severityName(entry.severity),
+                         int(entry.messageLength()), entry.message());
+        return size_t(n);
+    });
+    auto slow = std::make_shared<SlowSink>();
+    auto async = std::make_shared<AsyncSink>(slow, 4u);
+
+    Logger::instance().changeLog("/tmp/MyLogger/fanout.log");
+    Logger::instance().addSink(memory);
+    Logger::instance().addSink(file);
+    Logger::instance().addSink(async);
+
+    // The slow sink does not stall the logger: its lines are dropped.
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i)
+      {
+        LOGI("Info %d", i);
+      }
+    LOGW("Warning");
+    auto stop = std::chrono::steady_clock::now();
+    ASSERT_LT(stop - start, std::chrono::milliseconds(100));
+    async->drain();
+    ASSERT_LT(0u, async->dropped());
+    ASSERT_EQ(101u, slow->lines + async->dropped());
+
+    Logger::instance().removeSink(file);
+    LOGE("Not in the sink file");
+    Logger::destroy();
+    file.reset();
+
+    std::string const text = memory->content();
+    ASSERT_EQ(std::string::npos, text.find("Info"));
+    ASSERT_NE(std::string::npos, text.find("[WARNING][SinkTests.cpp::"));
+    ASSERT_NE(std::string::npos, text.find("Not in the sink file"));
+
+    std::string const formatted = content("/tmp/MyLogger/sink.log");
+    ASSERT_NE(std::string::npos, formatted.find("\n[INFO]|Info 99\n[WARNING]|Warning\n"));
+    ASSERT_EQ(std::string::npos, formatted.find("Not in the sink file"));
+}
+
+//--------------------------------------------------------------------------
+TEST(SinkTests, testMemoryRing)
+{
+    MemorySink memory(32u);
+    ISink& sink = memory;
+    const char* lines[] = { "first line\n", "second line\n", "third line\n" };
+
+    for (const char* line: lines)
+      {
+        LogEntry const entry = { Info, line, strlen(line), 0u };
+        sink.consume(entry);
+      }
+    ASSERT_EQ("second line\nthird line\n", memory.content());
+}
+
+//--------------------------------------------------------------------------
+//! \brief The formatter of an AsyncSink is applied before queueing.
+//--------------------------------------------------------------------------
+TEST(SinkTests, testAsyncFormatter)
+{
+    auto memory = std::make_shared<MemorySink>();
+    auto async = std::make_shared<AsyncSink>(memory);
+    async->formatter([](LogEntry const& entry, char* buffer, size_t const size)
+    {
+        int n = snprintf(buffer, size, "%s|%.*s", ILogger::severityName(entry.severity),
+                         int(entry.messageLength()), entry.message());
+        return size_t(n);
+    });
+
+    const char* line = "[00:00:00][INFO][SinkTests.cpp::1] hello\n";
+    LogEntry const entry = { Info, line, strlen(line), strlen(line) - 6u };
+    async->consume(entry);
+    async->drain();
+    ASSERT_EQ("[INFO]|hello\n", memory->content());
+}
+
+#if !defined(_WIN32)
+
+//--------------------------------------------------------------------------
+TEST(SinkTests, testSyslog)
+{
+    const char* path = "/tmp/MyLogger/syslog.sock";
+    unlink(path);
+
+    // Fake syslog daemon
+    int server = socket(AF_UNIX, SOCK_DGRAM, 0);
+    ASSERT_LE(0, server);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof (address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof (address.sun_path) - 1u);
+    ASSERT_EQ(0, bind(server, reinterpret_cast<struct sockaddr*>(&address), sizeof (address)));
+
+    auto syslog = std::make_shared<SyslogSink>("mylogger", SyslogSink::c_user, path);
+    ASSERT_TRUE(syslog->isOpen());
+    syslog->threshold(Info);
+
+    Logger::instance().changeLog("/tmp/MyLogger/syslog.log");
+    Logger::instance().addSink(syslog);
+    LOGE("Error %d", 42);
+    Logger::destroy();
+
+    char datagram[256];
+    ssize_t n = recv(server, datagram, sizeof (datagram) - 1u, MSG_DONTWAIT);
+    ASSERT_LT(0, n);
+    datagram[n] = '\0';
+    ASSERT_STREQ("<11>mylogger: Error 42", datagram);
+    close(server);
+    unlink(path);
+}
+
+#endif // !_WIN32
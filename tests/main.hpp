@@ -23,5 +23,18 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+//--------------------------------------------------------------------------
+//! \brief Return the whole content of a file (empty if it does not exist).
+//--------------------------------------------------------------------------
+inline std::string content(std::string const& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
 
 #endif // MAIN_HPP
@@ -0,0 +1,109 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+//! \brief Read-only mapping of log files in memory, shared by the command
+//! line tools.
+
+#ifndef MYLOGGER_TOOLS_MAPPING_HPP
+#  define MYLOGGER_TOOLS_MAPPING_HPP
+
+#  include <cstddef>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+
+namespace mylogger {
+
+// *****************************************************************************
+//! \brief A log file mapped in memory.
+// *****************************************************************************
+struct Mapping
+{
+    const char* data = nullptr;
+    size_t size = 0u;
+    //! \brief Bytes already given back to the system (see release()).
+    size_t released = 0u;
+};
+
+//------------------------------------------------------------------------------
+//! \brief Map a whole file in memory, read sequentially.
+//------------------------------------------------------------------------------
+inline bool map(const char* path, Mapping& mapping)
+{
+    int const fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    mapping.size = size_t(st.st_size);
+    if (mapping.size != 0u)
+    {
+        void* data = mmap(nullptr, mapping.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+        madvise(data, mapping.size, MADV_SEQUENTIAL);
+        mapping.data = static_cast<const char*>(data);
+    }
+    ::close(fd);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Give back to the system, by steps of the given size, the pages of a
+//! file already consumed.
+//------------------------------------------------------------------------------
+inline void release(Mapping& mapping, size_t const consumed, size_t const step)
+{
+    size_t const page = size_t(sysconf(_SC_PAGESIZE));
+    size_t const until = consumed - consumed % page;
+
+    if (until >= mapping.released + step)
+    {
+        madvise(const_cast<char*>(mapping.data) + mapping.released,
+                until - mapping.released, MADV_DONTNEED);
+        mapping.released = until;
+    }
+}
+
+//------------------------------------------------------------------------------
+//! \brief Unmap a file mapped by map().
+//------------------------------------------------------------------------------
+inline void unmap(Mapping& mapping)
+{
+    if (mapping.data != nullptr)
+    {
+        munmap(const_cast<char*>(mapping.data), mapping.size);
+        mapping.data = nullptr;
+    }
+}
+
+} // namespace mylogger
+
+#endif /* MYLOGGER_TOOLS_MAPPING_HPP */
@@ -0,0 +1,156 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+//! \brief mylogger-decode: convert a binary log file (see FileFormat::Binary)
+//! to the text format of Logger.
+
+#include "MyLogger/BinaryLog.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using namespace mylogger;
+
+//------------------------------------------------------------------------------
+static void usage(const char* name)
+{
+    std::cerr << "Usage: " << name << " [options] <binary log file>" << std::endl
+              << "  --level NAME  keep lines of this severity or higher "
+              << "(DEBUG, INFO, WARNING, FAILURE, ERROR, SIGNAL, THROW, CATCH, FATAL)"
+              << std::endl
+              << "  --from TIME   keep lines logged at or after TIME" << std::endl
+              << "  --to TIME     keep lines logged at or before TIME" << std::endl
+              << "  --file NAME   keep lines of the given source file" << std::endl
+              << "TIME is either seconds since the Epoch or a local date "
+              << "\"YYYY-MM-DD HH:MM:SS\"." << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Convert a time given on the command line to nanoseconds since the
+//! Epoch.
+//------------------------------------------------------------------------------
+static bool parseTime(const char* text, uint64_t& ns)
+{
+    struct tm tm;
+    memset(&tm, 0, sizeof (tm));
+    if (sscanf(text, "%d-%d-%d %d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec) == 6)
+    {
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        tm.tm_isdst = -1;
+        time_t const seconds = mktime(&tm);
+        if (seconds < 0)
+            return false;
+        ns = uint64_t(seconds) * 1000000000u;
+        return true;
+    }
+
+    char* end;
+    double const seconds = strtod(text, &end);
+    if ((end == text) || (*end != '\0') || (seconds < 0.0))
+        return false;
+    ns = uint64_t(seconds * 1e9);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    binary::Filter filter;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool const has_value = (i + 1 < argc);
+        if ((strcmp(argv[i], "--level") == 0) && has_value)
+        {
+            if (!ILogger::severity(argv[++i], filter.severity))
+            {
+                std::cerr << "Unknown severity '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], "--from") == 0) && has_value)
+        {
+            if (!parseTime(argv[++i], filter.from))
+            {
+                std::cerr << "Invalid time '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], "--to") == 0) && has_value)
+        {
+            if (!parseTime(argv[++i], filter.to))
+            {
+                std::cerr << "Invalid time '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], "--file") == 0) && has_value)
+        {
+            filter.file = argv[++i];
+        }
+        else if ((argv[i][0] != '-') && (path == nullptr))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (path == nullptr)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Failed opening '" << path << "'. Reason is '"
+                  << strerror(errno) << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string const content((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+
+    binary::Reader reader(content.data(), content.size(), filter);
+    if (!reader.valid())
+    {
+        std::cerr << "'" << path << "' is not a binary log file" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string line;
+    while (reader.next(line))
+    {
+        std::cout << line;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+//! \brief mylogger-grep: print the lines of text log files matching a
+//! severity, a time range, a location and/or a text, optionally helped by a
+//! sparse index saved next to each file (see LogIndex).
+
+#include "MyLogger/Grep.hpp"
+#include "MyLogger/ILogger.hpp"
+#include "Mapping.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mylogger;
+
+//------------------------------------------------------------------------------
+static void usage(const char* name)
+{
+    std::cerr << "Usage: " << name << " [options] <log file> [<log file> ...]" << std::endl
+              << "  --level NAME  keep lines of this severity or higher "
+              << "(DEBUG, INFO, WARNING, FAILURE, ERROR, SIGNAL, THROW, CATCH, FATAL)"
+              << std::endl
+              << "  --from TIME   keep lines logged at or after TIME" << std::endl
+              << "  --to TIME     keep lines logged at or before TIME" << std::endl
+              << "  --file NAME   keep lines of the source file NAME, or of the log "
+              << "statement NAME::LINE" << std::endl
+              << "  --text TEXT   keep lines containing TEXT" << std::endl
+              << "  --index       create or update the index <log file>.idx and use it"
+              << std::endl
+              << "  --count       only print the number of matching lines" << std::endl
+              << "TIME is a time of the day \"HH:MM[:SS[.fraction]]\". An existing "
+              << "index is used even without --index." << std::endl;
+}
+
+//------------------------------------------------------------------------------
+//! \brief Convert a time of the day given on the command line to nanoseconds.
+//------------------------------------------------------------------------------
+static bool parseTime(const char* text, int64_t& ns)
+{
+    unsigned hours, minutes;
+    double seconds = 0.0;
+    int consumed = 0;
+
+    int const fields = sscanf(text, "%u:%u%n:%lf%n", &hours, &minutes, &consumed,
+                              &seconds, &consumed);
+    if ((fields < 2) || (text[consumed] != '\0') || (hours > 23u) ||
+        (minutes > 59u) || (seconds < 0.0) || (seconds >= 60.0))
+    {
+        return false;
+    }
+    ns = (int64_t(hours) * 3600 + int64_t(minutes) * 60) * 1000000000 +
+         int64_t(seconds * 1e9);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    Grep::Query query;
+    bool index = false;
+    bool count = false;
+    std::vector<const char*> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool const has_value = (i + 1 < argc);
+        if ((strcmp(argv[i], "--level") == 0) && has_value)
+        {
+            if (!ILogger::severity(argv[++i], query.severity))
+            {
+                std::cerr << "Unknown severity '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], "--from") == 0) && has_value)
+        {
+            if (!parseTime(argv[++i], query.from))
+            {
+                std::cerr << "Invalid time '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], "--to") == 0) && has_value)
+        {
+            if (!parseTime(argv[++i], query.to))
+            {
+                std::cerr << "Invalid time '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if ((strcmp(argv[i], "--file") == 0) && has_value)
+        {
+            query.location = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--text") == 0) && has_value)
+        {
+            query.text = argv[++i];
+        }
+        else if (strcmp(argv[i], "--index") == 0)
+        {
+            index = true;
+        }
+        else if (strcmp(argv[i], "--count") == 0)
+        {
+            count = true;
+        }
+        else if (argv[i][0] != '-')
+        {
+            paths.push_back(argv[i]);
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (paths.empty())
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    static char output[1024u * 1024u];
+    setvbuf(stdout, output, _IOFBF, sizeof (output));
+
+    for (auto const& path: paths)
+    {
+        Mapping mapping;
+        if (!map(path, mapping))
+        {
+            std::cerr << "Failed opening '" << path << "'. Reason is '"
+                      << strerror(errno) << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        LogIndex sidecar;
+        std::string const sidecar_path = LogIndex::path(path);
+        bool const indexed = sidecar.load(sidecar_path);
+        if (index)
+        {
+            sidecar.update(mapping.data, mapping.size);
+            if (!sidecar.save(sidecar_path))
+            {
+                std::cerr << "Failed saving '" << sidecar_path << "'" << std::endl;
+            }
+        }
+
+        Grep grep(mapping.data, mapping.size, query,
+                  (index || indexed) ? &sidecar : nullptr);
+        Grep::Line line;
+        uint64_t matches = 0u;
+        while (grep.next(line))
+        {
+            ++matches;
+            if (count)
+                continue;
+            if (paths.size() > 1u)
+            {
+                fputs(path, stdout);
+                fputc(':', stdout);
+            }
+            fwrite(line.text, 1u, line.length, stdout);
+            if (line.text[line.length - 1u] != '\n')
+            {
+                fputc('\n', stdout);
+            }
+        }
+        if (count)
+        {
+            if (paths.size() > 1u)
+            {
+                printf("%s:", path);
+            }
+            printf("%llu\n", static_cast<unsigned long long>(matches));
+        }
+
+        unmap(mapping);
+    }
+    fflush(stdout);
+    return EXIT_SUCCESS;
+}
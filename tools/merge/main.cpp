@@ -0,0 +1,125 @@
+//=====================================================================
+// MyLogger: A basic logger.
+// Copyright 2018 Quentin Quadrat <lecrapouille@gmail.com>
+//
+// This file is part of MyLogger.
+//
+// MyLogger is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with MyLogger.  If not, see <http://www.gnu.org/licenses/>.
+//=====================================================================
+
+
+//! \brief mylogger-merge: merge log files whose lines are stamped (see
+//! Sequence) into a single stream ordered by time, written on the standard
+//! output.
+
+#include "MyLogger/Merger.hpp"
+#include "Mapping.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace mylogger;
+
+//! \brief Memory of the inputs is given back to the system by steps of this
+//! size once merged.
+static const size_t c_release_step = 16u * 1024u * 1024u;
+
+//------------------------------------------------------------------------------
+static void usage(const char* name)
+{
+    std::cerr << "Usage: " << name << " [options] <log file> [<log file> ...]" << std::endl
+              << "  --window N  lines read ahead in each file for reordering "
+              << "(default: 1024)" << std::endl
+              << "  --strip     remove the stamps from the lines" << std::endl
+              << "Lines shall have been stamped by mylogger::Sequence::enable(true)."
+              << std::endl;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char *argv[])
+{
+    size_t window = 1024u;
+    bool strip = false;
+    std::vector<const char*> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "--window") == 0) && (i + 1 < argc))
+        {
+            char* end;
+            window = size_t(strtoul(argv[++i], &end, 10));
+            if ((*end != '\0') || (window == 0u))
+            {
+                std::cerr << "Invalid window '" << argv[i] << "'" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--strip") == 0)
+        {
+            strip = true;
+        }
+        else if (argv[i][0] != '-')
+        {
+            paths.push_back(argv[i]);
+        }
+        else
+        {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (paths.empty())
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Merger merger(window);
+    std::vector<Mapping> mappings(paths.size());
+    for (size_t i = 0u; i < paths.size(); ++i)
+    {
+        if (!map(paths[i], mappings[i]))
+        {
+            std::cerr << "Failed opening '" << paths[i] << "'. Reason is '"
+                      << strerror(errno) << "'" << std::endl;
+            return EXIT_FAILURE;
+        }
+        merger.add(mappings[i].data, mappings[i].size);
+    }
+
+    static char output[1024u * 1024u];
+    setvbuf(stdout, output, _IOFBF, sizeof (output));
+
+    Merger::Line line;
+    uint64_t count = 0u;
+    while (merger.next(line))
+    {
+        size_t const skip = strip ? line.stamp : 0u;
+        fwrite(line.text + skip, 1u, line.length - skip, stdout);
+        if ((++count & 0xffffu) == 0u)
+        {
+            for (size_t i = 0u; i < mappings.size(); ++i)
+            {
+                release(mappings[i], merger.consumed(i), c_release_step);
+            }
+        }
+    }
+    fflush(stdout);
+    return EXIT_SUCCESS;
+}